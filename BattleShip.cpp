@@ -1,48 +1,388 @@
 ﻿#include <iostream>
 #include <vector>
+#include <span>
 #include <map>
+#include <unordered_map>
 #include <cstdlib>
+#include <cstdio>
 #include <ctime>
 #include <thread>
 #include <chrono>
 #include <limits>
+#ifdef _WIN32
 #include <conio.h>
 #include <windows.h> // For color and animation
+#else
+#include <termios.h>
+#include <unistd.h>
+#include <poll.h>
+#include <csignal>
+#include <cerrno>
+#endif
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#endif
 #include <memory>
 #include <iomanip>
 #include <queue>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using namespace std;
 
 
 #include "class.h"
+#include "server.h"
 
 
-int main() {
-	srand(static_cast<unsigned>(time(nullptr)));  // Random seed initialization
+// BattleShip.exe --simulate N [--threads T] [--size S] [--ai hunt|density|montecarlo]
+//                [--budget-us U] [--seed S] [--format csv|json] [--out file]
+//                [--record archive] [--keyframe K] [--salvo]
+int runSimulation(int argc, char* argv[]) {
+	long long games = 0;
+	int threads = 0;
+	int boardSize = STANDARD_BOARD_SIZE;
+	AIStrategy strategy = AIStrategy::Hunt;
+	chrono::microseconds budget = ComputerPlayer::thinkBudget(Difficulty::Easy);
+	uint64_t seed = Rng().next();
+	string format = "csv";
+	string outPath;
+	string recordPath;
+	int keyframeInterval = GameRecord::DEFAULT_KEYFRAME_INTERVAL;
+	bool salvo = false;
 
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--simulate" && hasValue) games = atoll(argv[++i]);
+		else if (arg == "--threads" && hasValue) threads = atoi(argv[++i]);
+		else if (arg == "--size" && hasValue) boardSize = atoi(argv[++i]);
+		else if (arg == "--ai" && hasValue) {
+			string name = argv[++i];
+			if (name == "hunt") strategy = AIStrategy::Hunt;
+			else if (name == "density") strategy = AIStrategy::Density;
+			else if (name == "montecarlo") strategy = AIStrategy::MonteCarlo;
+			else throw invalid_argument("Unknown AI strategy: " + name);
+		}
+		else if (arg == "--budget-us" && hasValue) budget = chrono::microseconds(atoll(argv[++i]));
+		else if (arg == "--seed" && hasValue) seed = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--format" && hasValue) format = argv[++i];
+		else if (arg == "--out" && hasValue) outPath = argv[++i];
+		else if (arg == "--record" && hasValue) recordPath = argv[++i];
+		else if (arg == "--keyframe" && hasValue) keyframeInterval = atoi(argv[++i]);
+		else if (arg == "--salvo") salvo = true;
+		else throw invalid_argument("Unknown or incomplete option: " + arg);
+	}
+
+	if (games <= 0 || !FleetSampler::fits(boardSize, StandardFleet::lengths())) {
+		throw invalid_argument("--simulate needs a positive game count and a --size the fleet fits on (7 or more)");
+	}
+	if (salvo && !recordPath.empty()) {
+		throw invalid_argument("--record cannot be used with --salvo");
+	}
+
+	Simulation simulation(boardSize, threads, strategy, budget, seed);
+	simulation.setSalvo(salvo);
+	unique_ptr<GameArchiveWriter> archive;
+	if (!recordPath.empty()) {
+		if (keyframeInterval < 1) throw invalid_argument("--keyframe must be positive");
+		archive = make_unique<GameArchiveWriter>(recordPath);
+		simulation.setArchive(archive.get(), keyframeInterval);
+	}
+	SimulationReport report = simulation.run(games);
+
+	ofstream file;
+	if (!outPath.empty()) {
+		file.open(outPath);
+		if (!file) throw runtime_error("Cannot open " + outPath);
+	}
+	ostream& out = outPath.empty() ? cout : file;
+
+	if (format == "json") report.writeJson(out);
+	else report.writeCsv(out);
+
+	return EXIT_SUCCESS;
+}
+
+
+// BattleShip.exe --tournament N [--entrants random,hunt,density,montecarlo] [--threads T]
+//                [--size S] [--budget-us U] [--seed S] [--batch B] [--min-games M]
+//                [--no-early-stop] [--format text|json] [--out file]
+int runTournament(int argc, char* argv[]) {
+	long long games = 0;
+	int threads = 0;
+	int boardSize = STANDARD_BOARD_SIZE;
+	chrono::microseconds budget = ComputerPlayer::thinkBudget(Difficulty::Easy);
+	uint64_t seed = Rng().next();
+	string entrants = "random,hunt,density,montecarlo";
+	long long batch = 32;
+	long long minGames = 200;
+	bool earlyStop = true;
+	string format = "text";
+	string outPath;
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--tournament" && hasValue) games = atoll(argv[++i]);
+		else if (arg == "--entrants" && hasValue) entrants = argv[++i];
+		else if (arg == "--threads" && hasValue) threads = atoi(argv[++i]);
+		else if (arg == "--size" && hasValue) boardSize = atoi(argv[++i]);
+		else if (arg == "--budget-us" && hasValue) budget = chrono::microseconds(atoll(argv[++i]));
+		else if (arg == "--seed" && hasValue) seed = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--batch" && hasValue) batch = atoll(argv[++i]);
+		else if (arg == "--min-games" && hasValue) minGames = atoll(argv[++i]);
+		else if (arg == "--no-early-stop") earlyStop = false;
+		else if (arg == "--format" && hasValue) format = argv[++i];
+		else if (arg == "--out" && hasValue) outPath = argv[++i];
+		else throw invalid_argument("Unknown or incomplete option: " + arg);
+	}
+
+	if (games <= 0 || !FleetSampler::fits(boardSize, StandardFleet::lengths())) {
+		throw invalid_argument("--tournament needs a positive game count per pairing and a --size the fleet fits on (7 or more)");
+	}
+
+	Tournament tournament(boardSize, threads, seed, budget);
+	size_t from = 0;
+	while (from <= entrants.size()) {
+		size_t comma = entrants.find(',', from);
+		if (comma == string::npos) comma = entrants.size();
+		if (comma > from) tournament.addEntrant(entrants.substr(from, comma - from));
+		from = comma + 1;
+	}
+	tournament.setBatchSize(batch);
+	if (!earlyStop) tournament.setEarlyStop(0, 0.0, 0.0);
+	else tournament.setEarlyStop(minGames, 3.0, 0.02);
+
+	TournamentReport report = tournament.run(games);
+
+	ofstream file;
+	if (!outPath.empty()) {
+		file.open(outPath);
+		if (!file) throw runtime_error("Cannot open " + outPath);
+	}
+	ostream& out = outPath.empty() ? cout : file;
+
+	if (format == "json") report.writeJson(out);
+	else report.writeText(out);
+
+	return EXIT_SUCCESS;
+}
+
+// BattleShip.exe --replay archive [--list] [--game N] [--turn T]
+int runReplay(int argc, char* argv[]) {
+	string path;
+	bool list = false;
+	size_t gameNumber = 0;
+	int turn = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--replay" && hasValue) path = argv[++i];
+		else if (arg == "--list") list = true;
+		else if (arg == "--game" && hasValue) gameNumber = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--turn" && hasValue) turn = atoi(argv[++i]);
+		else throw invalid_argument("Unknown or incomplete option: " + arg);
+	}
+
+	GameArchiveReader archive(path);
+	GameRecord record;
+
+	if (list) {
+		cout << "#,game,seed,winner,shots,bytes\n";
+		for (size_t n = 0; n < archive.getGameCount(); ++n) {
+			archive.load(n, record);
+			cout << n << "," << record.getGameIndex() << "," << record.getSeed() << ","
+				<< record.getWinner() + 1 << "," << record.getShotCount() << ","
+				<< archive.getRecordBytes(n) << "\n";
+		}
+		return EXIT_SUCCESS;
+	}
+
+	if (gameNumber >= archive.getGameCount()) {
+		throw invalid_argument("--game must be below " + to_string(archive.getGameCount()));
+	}
+	archive.load(gameNumber, record);
+
+	Game game(nullptr, nullptr);
+	game.replay(record, turn);
+	return EXIT_SUCCESS;
+}
+
+#ifdef __linux__
+static GameServer* g_server = nullptr;
+
+static void stopServer(int) {
+	if (g_server) g_server->stop();
+}
+
+// BattleShip.exe --server socket [--workers W]
+int runServer(int argc, char* argv[]) {
+	string path;
+	int workers = 0;
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--server" && hasValue) path = argv[++i];
+		else if (arg == "--workers" && hasValue) workers = atoi(argv[++i]);
+		else throw invalid_argument("Unknown or incomplete option: " + arg);
+	}
+	if (path.empty()) throw invalid_argument("--server needs a socket path");
+
+	GameServer server(path, workers);
+	g_server = &server;
+	signal(SIGINT, stopServer);
+	signal(SIGTERM, stopServer);
+
+	cout << "Listening on " << path << endl;
+	server.run();
+	g_server = nullptr;
+	return EXIT_SUCCESS;
+}
+
+// BattleShip.exe --client socket [--connections C] [--games N] [--ai hunt|density|...] [--seed S]
+int runClient(int argc, char* argv[]) {
+	string path;
+	int connections = 1;
+	int games = 1;
+	string strategy = "hunt";
+	uint64_t seed = Rng().next();
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--client" && hasValue) path = argv[++i];
+		else if (arg == "--connections" && hasValue) connections = atoi(argv[++i]);
+		else if (arg == "--games" && hasValue) games = atoi(argv[++i]);
+		else if (arg == "--ai" && hasValue) strategy = argv[++i];
+		else if (arg == "--seed" && hasValue) seed = strtoull(argv[++i], nullptr, 10);
+		else throw invalid_argument("Unknown or incomplete option: " + arg);
+	}
+	if (connections < 1 || games < 1) throw invalid_argument("--connections and --games must be positive");
+
+	GameClient client(path);
+	GameClient::Summary summary = client.run(connections, games, strategy, seed);
+
+	cout << "connections,games,won,lost,commands,errors,seconds,commands_per_second\n"
+		<< connections << "," << summary.games << "," << summary.won << "," << summary.lost << ","
+		<< summary.commands << "," << summary.errors << "," << summary.seconds << ","
+		<< (summary.seconds > 0 ? summary.commands / summary.seconds : 0) << "\n";
+	return summary.errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
+
+bool hasOption(int argc, char* argv[], const string& option) {
+	for (int i = 1; i < argc; ++i) {
+		if (option == argv[i]) return true;
+	}
+	return false;
+}
+
+
+// BattleShip.exe [--record archive] [--metrics-overlay] [--salvo] [--save file] [--resume file]
+int runGame(int argc, char* argv[]) {
+	// Create game boards
+	const int boardSize = STANDARD_BOARD_SIZE;
+	auto board1 = make_shared<Board>(boardSize);
+	auto board2 = make_shared<Board>(boardSize);
+
+	// Create players (will be overridden by game mode selection)
+	unique_ptr<Player>player1 = make_unique<HumanPlayer>(*board1);
+	unique_ptr<Player>player2 = make_unique<HumanPlayer>(*board2);
+
+	// Initialize and run the game
+	Game game(player1.get(), player2.get());
+
+	bool recording = false, salvo = false, resuming = false;
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		if (arg == "--record" && i + 1 < argc) {
+			game.setRecordPath(argv[++i]);
+			recording = true;
+		}
+		else if (arg == "--metrics-overlay") {
+			Metrics::setEnabled(true);
+			game.setMetricsOverlay(true);
+		}
+		else if (arg == "--salvo") salvo = true;
+		else if (arg == "--save" && i + 1 < argc) game.setSavePath(argv[++i]);
+		else if (arg == "--resume" && i + 1 < argc) {
+			game.setResumePath(argv[++i]);
+			resuming = true;
+		}
+		else throw invalid_argument("Unknown or incomplete option: " + arg);
+	}
+	if (salvo && recording) throw invalid_argument("--record cannot be used with --salvo");
+	if (resuming && recording) throw invalid_argument("--record cannot be used with --resume");
+	game.setSalvo(salvo);
+	game.start();
+	return EXIT_SUCCESS;
+}
+
+int runMode(int argc, char* argv[]) {
+	if (hasOption(argc, argv, "--simulate")) {
+		return runSimulation(argc, argv);
+	}
+	if (hasOption(argc, argv, "--tournament")) {
+		return runTournament(argc, argv);
+	}
+	if (hasOption(argc, argv, "--replay")) {
+		return runReplay(argc, argv);
+	}
+	if (hasOption(argc, argv, "--server") || hasOption(argc, argv, "--client")) {
+#ifdef __linux__
+		return hasOption(argc, argv, "--server") ? runServer(argc, argv) : runClient(argc, argv);
+#else
+		throw runtime_error("Server mode is only available on Linux");
+#endif
+	}
+	return runGame(argc, argv);
+}
+
+
+int main(int argc, char* argv[]) {
 	try
 	{
-		// Create game boards
-		const int boardSize = 10;
-		auto board1 = make_shared<Board>(boardSize);
-		auto board2 = make_shared<Board>(boardSize);
+		// --metrics file works with every mode: counters and histograms are written there on exit
+		string metricsPath;
+		vector<char*> args;
+		for (int i = 0; i < argc; ++i) {
+			if (string(argv[i]) == "--metrics" && i + 1 < argc) metricsPath = argv[++i];
+			else args.push_back(argv[i]);
+		}
+		if (!metricsPath.empty()) Metrics::setEnabled(true);
 
-		// Create players (will be overridden by game mode selection)
-		unique_ptr<Player>player1 = make_unique<HumanPlayer>(*board1);
-		unique_ptr<Player>player2 = make_unique<HumanPlayer>(*board2);
-
-		// Initialize and run the game
-		Game game(player1.get(), player2.get());
-		game.start();
+		int status = runMode(static_cast<int>(args.size()), args.data());
+		if (!metricsPath.empty()) Metrics::dump(metricsPath);
+		return status;
 	}
 	catch (const exception& e)
 	{
 		cerr << "Error: " << e.what() << endl;
 		return EXIT_FAILURE;
 	}
-
-	return EXIT_SUCCESS;
-
-	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,418 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <map>
+#include <unordered_map>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <iomanip>
+#include <queue>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <new>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+
+#include "engine.h"
+
+
+// Every heap allocation in the process goes through here so each benchmark
+// can report allocations per operation next to its timing.
+static atomic<long long> g_allocations(0);
+
+// Kept out of line so GCC does not pair the inlined malloc/free with new/delete
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* operator new(size_t size) {
+	g_allocations.fetch_add(1, memory_order_relaxed);
+	if (void* p = malloc(size ? size : 1)) return p;
+	throw bad_alloc();
+}
+
+BENCH_NOINLINE void operator delete(void* p) noexcept {
+	free(p);
+}
+
+BENCH_NOINLINE void operator delete(void* p, size_t) noexcept {
+	free(p);
+}
+
+
+struct BenchResult {
+	string name;
+	double nsPerOp;
+	double allocsPerOp;
+};
+
+// Runs body in growing batches until one batch takes at least minTime
+template <class Body>
+BenchResult measure(const string& name, Body body,
+	chrono::milliseconds minTime = chrono::milliseconds(200)) {
+	long long iterations = 1;
+	while (true) {
+		long long allocationsBefore = g_allocations.load();
+		auto started = chrono::steady_clock::now();
+		for (long long i = 0; i < iterations; ++i) {
+			body();
+		}
+		auto elapsed = chrono::steady_clock::now() - started;
+		long long allocations = g_allocations.load() - allocationsBefore;
+
+		if (elapsed >= minTime || iterations >= (1LL << 40)) {
+			double ns = chrono::duration<double, nano>(elapsed).count();
+			return BenchResult{ name, ns / iterations, static_cast<double>(allocations) / iterations };
+		}
+		iterations *= 2;
+	}
+}
+
+// Keeps the optimizer from dropping results we do not otherwise use
+static volatile long long g_sink = 0;
+
+// Compound assignment to a volatile is deprecated since C++20
+inline void sink(long long value) {
+	g_sink = g_sink + value;
+}
+
+
+vector<BenchResult> runBenchmarks() {
+	const int size = STANDARD_BOARD_SIZE;
+	const vector<int> fleet = StandardFleet::lengths();
+	vector<BenchResult> results;
+	Rng rng(12345);
+
+	// A board with the standard fleet on it, reused as the starting point
+	Board placed(size);
+	FleetSampler sampler(size, fleet);
+	vector<int> placements;
+	sampler.placeFleet(placed, rng, placements);
+
+	// Pre-generated queries so the RNG is not part of the measurement
+	vector<Ship> queries;
+	for (int i = 0; i < 1024; ++i) {
+		queries.push_back(Ship(Point(rng.nextInt(size), rng.nextInt(size)), rng.nextBool(), 1 + rng.nextInt(4)));
+	}
+
+	size_t q = 0;
+	results.push_back(measure("Board::canPlaceShip(Ship)", [&] {
+		sink(placed.canPlaceShip(queries[q++ & 1023]));
+	}));
+
+	q = 0;
+	results.push_back(measure("Board::canPlaceShip(Point,len,dir)", [&] {
+		const Ship& s = queries[q++ & 1023];
+		sink(placed.canPlaceShip(s.getStart(), s.getLength(), s.isHorizontal()));
+	}));
+
+	Board scratch(size);
+	const PlacementTable& table = sampler.getTable();
+	results.push_back(measure("Board::placeShip x10 + reset", [&] {
+		scratch.reset();
+		for (int p : placements) {
+			sink(scratch.placeShip(table.getStart(p), table.getLength(p), table.isHorizontal(p)));
+		}
+	}));
+
+	vector<Point> cells;
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) cells.push_back(Point(x, y));
+	}
+	shuffle(cells.begin(), cells.end(), rng);
+	results.push_back(measure("Board::attack x100 + board copy", [&] {
+		scratch = placed;
+		for (const Point& p : cells) sink(scratch.attack(p).isHit());
+	}));
+
+	// The same 100 shots as ten salvos of ten
+	results.push_back(measure("Board::attackBatch 10x10 + board copy", [&] {
+		scratch = placed;
+		for (size_t i = 0; i < cells.size(); i += 10) {
+			sink(static_cast<long long>(scratch.attackBatch(span<const Point>(cells).subspan(i, 10))));
+		}
+	}));
+
+	// Same shots again, reporting to an event ring that is drained after every pass
+	EventRing events;
+	Board reporting = placed;
+	reporting.setEvents(&events, 0);
+	results.push_back(measure("Board::attack x100 + board copy (events)", [&] {
+		scratch = reporting;
+		for (const Point& p : cells) sink(scratch.attack(p).isHit());
+		sink(events.drain([](const GameEvent&) {}));
+	}));
+	scratch.setEvents(nullptr, 0);
+
+	results.push_back(measure("Board::allShipsSunk", [&] {
+		sink(placed.allShipsSunk());
+	}));
+
+	results.push_back(measure("Board::reset", [&] {
+		scratch.reset();
+	}));
+
+	// Same shots as the board copy above, on a snapshot of both boards
+	const GameState state = GameState::capture(placed, placed);
+	GameState snapshot = state;
+	vector<int> cellIndices;
+	for (const Point& p : cells) cellIndices.push_back(p.getY() * size + p.getX());
+	results.push_back(measure("GameState copy", [&] {
+		snapshot = state;
+		sink(snapshot.getDepth());
+	}));
+
+	q = 0;
+	results.push_back(measure("GameState::push + pop", [&] {
+		sink(snapshot.push(cellIndices[q++ % cellIndices.size()]));
+		snapshot.pop();
+	}));
+
+	// Both players at every cell: the deepest line a whole game can take
+	results.push_back(measure("GameState::push x200 + pop x200", [&] {
+		for (int i = 0; i < 2 * size * size; ++i) sink(snapshot.push(cellIndices[i % cellIndices.size()]));
+		for (int i = 0; i < 2 * size * size; ++i) snapshot.pop();
+	}));
+
+	// A late game: every cell fired at but the last 20 of the shuffled order
+	vector<char> lateGame(size * size, CELL_UNKNOWN);
+	for (size_t i = 0; i + 20 < cellIndices.size(); ++i) {
+		lateGame[cellIndices[i]] = placed.getShipMask().test(cellIndices[i]) ? CELL_HIT : CELL_EMPTY;
+	}
+	EndgameSolver endgame(size, fleet);
+	results.push_back(measure("EndgameSolver::solve (20 cells unknown)", [&] {
+		sink(endgame.solve(lateGame, fleet, chrono::seconds(10), 1));
+	}));
+
+	// Recording cost with metrics switched on; everything else runs with them off
+	Metrics::setEnabled(true);
+	results.push_back(measure("Metrics::count (enabled)", [&] {
+		Metrics::count(Counter::BoardAttacks);
+	}));
+	results.push_back(measure("Metrics::Timer (enabled)", [&] {
+		Metrics::Timer timer(Histogram::AiThink);
+	}));
+	Metrics::setEnabled(false);
+	results.push_back(measure("Metrics::count (disabled)", [&] {
+		Metrics::count(Counter::BoardAttacks);
+	}));
+
+	const AIStrategy strategies[] = { AIStrategy::Hunt, AIStrategy::Density };
+	const char* strategyNames[] = { "hunt", "density" };
+
+	for (int s = 0; s < 2; ++s) {
+		Board own(size);
+		ComputerPlayer computer(own, strategies[s], Rng(7));
+		string suffix = string(" [") + strategyNames[s] + "]";
+
+		if (s == 0) {
+			results.push_back(measure("ComputerPlayer::placeShips (reset + place)", [&] {
+				computer.reset();
+				computer.placeShips(true);
+			}));
+
+			// Checking out a warm session and setting it up for the next game
+			SessionPool pool(size);
+			pool.reserve(1, "hunt", "hunt");
+			uint64_t seed = 0;
+			results.push_back(measure("SessionPool acquire + reset + place [hunt]", [&] {
+				SessionPool::Lease game = pool.acquire("hunt", "hunt");
+				game->reset(seed++);
+				game->getPlayer(0).placeShips(true);
+				game->getPlayer(1).placeShips(true);
+			}));
+		}
+
+		// Per shot: selectAttack + processAttackResult against a fixed fleet
+		long long shots = 0;
+		long long allocationsBefore = g_allocations.load();
+		auto started = chrono::steady_clock::now();
+		while (chrono::steady_clock::now() - started < chrono::milliseconds(200)) {
+			computer.reset();
+			scratch = placed;
+			while (!scratch.allShipsSunk()) {
+				Point p = computer.selectAttack();
+				computer.processAttackResult(p, scratch.attack(p));
+				++shots;
+			}
+		}
+		double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - started).count();
+		long long allocations = g_allocations.load() - allocationsBefore;
+		results.push_back(BenchResult{ "ComputerPlayer::selectAttack" + suffix,
+			ns / shots, static_cast<double>(allocations) / shots });
+
+		// Save and resume of this player 40 shots into a game
+		computer.reset();
+		computer.placeShips(true);
+		scratch = placed;
+		for (int i = 0; i < 40; ++i) {
+			Point p = computer.selectAttack();
+			computer.processAttackResult(p, scratch.attack(p));
+		}
+		BinaryWriter saved;
+		results.push_back(measure("ComputerPlayer::saveState" + suffix, [&] {
+			saved.clear();
+			computer.saveState(saved);
+		}));
+
+		Board restoredBoard(size);
+		ComputerPlayer restored(restoredBoard, strategies[s]);
+		results.push_back(measure("ComputerPlayer::loadState" + suffix, [&] {
+			BinaryReader in(saved.data().data(), saved.size());
+			restored.loadState(in);
+		}));
+	}
+
+	for (int s = 0; s < 2; ++s) {
+		Board board1(size), board2(size);
+		ComputerPlayer player1(board1, strategies[s]), player2(board2, strategies[s]);
+		long long game = 0;
+
+		results.push_back(measure(string("headless game [") + strategyNames[s] + "]", [&] {
+			Simulation::seedGame(player1, player2, Rng::derive(99, game++));
+			player1.reset();
+			player2.reset();
+			player1.placeShips(true);
+			player2.placeShips(true);
+			sink(Simulation::playGame(player1, player2, size).totalShots);
+		}));
+
+		game = 0;
+		results.push_back(measure(string("headless salvo game [") + strategyNames[s] + "]", [&] {
+			Simulation::seedGame(player1, player2, Rng::derive(99, game++));
+			player1.reset();
+			player2.reset();
+			player1.placeShips(true);
+			player2.placeShips(true);
+			sink(Simulation::playSalvoGame(player1, player2, size).totalShots);
+		}));
+
+		// Same games through the virtual Player interface, as mixed modes play them
+		Player& virtual1 = player1;
+		Player& virtual2 = player2;
+		game = 0;
+		results.push_back(measure(string("headless game via Player& [") + strategyNames[s] + "]", [&] {
+			Simulation::seedGame(virtual1, virtual2, Rng::derive(99, game++));
+			virtual1.reset();
+			virtual2.reset();
+			virtual1.placeShips(true);
+			virtual2.placeShips(true);
+			sink(Simulation::playGame(virtual1, virtual2, size).totalShots);
+		}));
+	}
+
+	return results;
+}
+
+
+map<string, BenchResult> loadBaseline(const string& path) {
+	map<string, BenchResult> baseline;
+	ifstream in(path);
+	string line;
+	while (getline(in, line)) {
+		// name<TAB>ns<TAB>allocs
+		size_t first = line.find('\t');
+		size_t second = line.find('\t', first + 1);
+		if (first == string::npos || second == string::npos) continue;
+		BenchResult r;
+		r.name = line.substr(0, first);
+		r.nsPerOp = atof(line.substr(first + 1, second - first - 1).c_str());
+		r.allocsPerOp = atof(line.substr(second + 1).c_str());
+		baseline[r.name] = r;
+	}
+	return baseline;
+}
+
+void saveBaseline(const string& path, const vector<BenchResult>& results) {
+	ofstream out(path);
+	if (!out) throw runtime_error("Cannot write " + path);
+	for (const auto& r : results) {
+		out << r.name << '\t' << r.nsPerOp << '\t' << r.allocsPerOp << '\n';
+	}
+}
+
+
+// battleship_bench [--baseline file] [--save-baseline file] [--tolerance pct]
+int main(int argc, char* argv[]) {
+	string baselinePath;
+	string savePath;
+	double tolerance = 10.0;
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--baseline" && hasValue) baselinePath = argv[++i];
+		else if (arg == "--save-baseline" && hasValue) savePath = argv[++i];
+		else if (arg == "--tolerance" && hasValue) tolerance = atof(argv[++i]);
+		else {
+			cerr << "Usage: " << argv[0] << " [--baseline file] [--save-baseline file] [--tolerance pct]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	try
+	{
+		vector<BenchResult> results = runBenchmarks();
+		map<string, BenchResult> baseline;
+		if (!baselinePath.empty()) baseline = loadBaseline(baselinePath);
+
+		int regressions = 0;
+		cout << left << setw(46) << "benchmark" << right << setw(14) << "ns/op"
+			<< setw(14) << "allocs/op" << setw(12) << "vs base" << endl;
+
+		for (const auto& r : results) {
+			cout << left << setw(46) << r.name << right << fixed << setprecision(1)
+				<< setw(14) << r.nsPerOp << setprecision(2) << setw(14) << r.allocsPerOp;
+
+			auto base = baseline.find(r.name);
+			if (base != baseline.end() && base->second.nsPerOp > 0) {
+				double change = 100.0 * (r.nsPerOp - base->second.nsPerOp) / base->second.nsPerOp;
+				bool slower = change > tolerance;
+				bool moreAllocs = r.allocsPerOp > base->second.allocsPerOp + 0.01;
+				cout << setw(11) << showpos << setprecision(1) << change << "%" << noshowpos;
+				if (slower || moreAllocs) {
+					cout << "  REGRESSION" << (moreAllocs ? " (allocations)" : "");
+					++regressions;
+				}
+			}
+			cout << endl;
+		}
+
+		if (!savePath.empty()) saveBaseline(savePath, results);
+
+		if (regressions > 0) {
+			cout << regressions << " regression(s) against " << baselinePath << endl;
+			return EXIT_FAILURE;
+		}
+	}
+	catch (const exception& e)
+	{
+		cerr << "Error: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+
+// Little-endian byte buffer writer for the binary file formats.
+// Integers that are usually small (counts, cell indices) go in as LEB128
+// varints so they take one byte on the standard board.
+class BinaryWriter {
+private:
+	vector<uint8_t> _data;
+
+public:
+	void writeU8(uint8_t value) {
+		_data.push_back(value);
+	}
+
+	void writeU32(uint32_t value) {
+		for (int i = 0; i < 4; ++i) _data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+
+	void writeU64(uint64_t value) {
+		for (int i = 0; i < 8; ++i) _data.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+
+	void writeVarint(uint64_t value) {
+		while (value >= 0x80) {
+			_data.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		_data.push_back(static_cast<uint8_t>(value));
+	}
+
+	void writeBytes(const uint8_t* bytes, size_t count) {
+		_data.insert(_data.end(), bytes, bytes + count);
+	}
+
+	// First byteCount bytes of the mask, low bits first
+	void writeBits(const BitBoard& bits, int byteCount) {
+		for (int i = 0; i < byteCount; ++i) {
+			_data.push_back(static_cast<uint8_t>(bits.getWord(i >> 3) >> (8 * (i & 7))));
+		}
+	}
+
+	const vector<uint8_t>& data() const { return _data; }
+	size_t size() const { return _data.size(); }
+	void clear() { _data.clear(); }
+};
+
+// Reads what BinaryWriter wrote; throws instead of reading past the end.
+class BinaryReader {
+private:
+	const uint8_t* _data;
+	size_t _size;
+	size_t _pos;
+
+	void require(size_t count) const {
+		if (count > _size - _pos) throw runtime_error("Unexpected end of binary data");
+	}
+
+public:
+	BinaryReader(const uint8_t* data, size_t size) : _data(data), _size(size), _pos(0) {
+	}
+
+	uint8_t readU8() {
+		require(1);
+		return _data[_pos++];
+	}
+
+	uint32_t readU32() {
+		require(4);
+		uint32_t value = 0;
+		for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(_data[_pos++]) << (8 * i);
+		return value;
+	}
+
+	uint64_t readU64() {
+		require(8);
+		uint64_t value = 0;
+		for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(_data[_pos++]) << (8 * i);
+		return value;
+	}
+
+	uint64_t readVarint() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			uint8_t byte = readU8();
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80)) return value;
+		}
+		throw runtime_error("Malformed varint in binary data");
+	}
+
+	void readBits(BitBoard& bits, int byteCount) {
+		require(byteCount);
+		bits.clear();
+		for (int i = 0; i < byteCount; ++i) {
+			uint8_t byte = _data[_pos++];
+			for (int b = 0; b < 8; ++b) {
+				int cell = i * 8 + b;
+				if ((byte >> b) & 1) {
+					if (cell >= bits.getBitCount()) throw runtime_error("Bit mask out of range");
+					bits.set(cell);
+				}
+			}
+		}
+	}
+
+	const uint8_t* current() const { return _data + _pos; }
+
+	void skip(size_t count) {
+		require(count);
+		_pos += count;
+	}
+
+	size_t position() const { return _pos; }
+	size_t remaining() const { return _size - _pos; }
+	bool atEnd() const { return _pos == _size; }
+};
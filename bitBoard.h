@@ -0,0 +1,150 @@
+#pragma once
+
+
+inline int popCount(uint64_t word) {
+#ifdef _MSC_VER
+	return static_cast<int>(__popcnt64(word));
+#else
+	return __builtin_popcountll(word);
+#endif
+}
+
+// Index of the lowest set bit; word must not be 0
+inline int countTrailingZeros(uint64_t word) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+// Bit-per-cell mask used for the board layers. Bits are stored row-major
+// (index = y * size + x). Up to 128 cells (the standard 10x10 board) live
+// inline without touching the heap; larger boards fall back to a vector.
+class BitBoard {
+private:
+	static const int INLINE_WORDS = 2;
+
+	int _bits;
+	int _words;
+	uint64_t _inline[INLINE_WORDS];
+	vector<uint64_t> _heap;
+
+	// Mask of bits [from, to) inside a single word
+	static uint64_t wordMask(int from, int to) {
+		uint64_t high = (to >= 64) ? ~0ULL : ((1ULL << to) - 1);
+		uint64_t low = (1ULL << from) - 1;
+		return high & ~low;
+	}
+
+public:
+	BitBoard(int bits = 0) : _bits(bits), _words((bits + 63) / 64) {
+		_inline[0] = _inline[1] = 0;
+		if (_words > INLINE_WORDS) {
+			_heap.assign(_words, 0);
+		}
+	}
+
+	uint64_t* words() { return _words <= INLINE_WORDS ? _inline : _heap.data(); }
+	const uint64_t* words() const { return _words <= INLINE_WORDS ? _inline : _heap.data(); }
+
+	int getBitCount() const { return _bits; }
+	int getWordCount() const { return _words; }
+	uint64_t getWord(int w) const { return words()[w]; }
+
+	void clear() {
+		uint64_t* w = words();
+		for (int i = 0; i < _words; ++i) w[i] = 0;
+	}
+
+	bool test(int i) const { return (words()[i >> 6] >> (i & 63)) & 1; }
+	void set(int i) { words()[i >> 6] |= 1ULL << (i & 63); }
+	void reset(int i) { words()[i >> 6] &= ~(1ULL << (i & 63)); }
+
+	// Sets bits [first, first + count)
+	void setRange(int first, int count) {
+		uint64_t* w = words();
+		int end = first + count;
+		while (first < end) {
+			int word = first >> 6;
+			int to = min(end - (word << 6), 64);
+			w[word] |= wordMask(first & 63, to);
+			first = (word << 6) + to;
+		}
+	}
+
+	// True if any bit in [first, first + count) is set
+	bool anyInRange(int first, int count) const {
+		const uint64_t* w = words();
+		int end = first + count;
+		while (first < end) {
+			int word = first >> 6;
+			int to = min(end - (word << 6), 64);
+			if (w[word] & wordMask(first & 63, to)) return true;
+			first = (word << 6) + to;
+		}
+		return false;
+	}
+
+	bool any() const {
+		const uint64_t* w = words();
+		for (int i = 0; i < _words; ++i) {
+			if (w[i]) return true;
+		}
+		return false;
+	}
+
+	bool none() const { return !any(); }
+
+	int count() const {
+		const uint64_t* w = words();
+		int total = 0;
+		for (int i = 0; i < _words; ++i) total += popCount(w[i]);
+		return total;
+	}
+
+	bool intersects(const BitBoard& other) const {
+		const uint64_t* a = words();
+		const uint64_t* b = other.words();
+		for (int i = 0; i < _words; ++i) {
+			if (a[i] & b[i]) return true;
+		}
+		return false;
+	}
+
+	// True if every bit set here is also set in other
+	bool isSubsetOf(const BitBoard& other) const {
+		const uint64_t* a = words();
+		const uint64_t* b = other.words();
+		for (int i = 0; i < _words; ++i) {
+			if (a[i] & ~b[i]) return false;
+		}
+		return true;
+	}
+
+	BitBoard& operator|=(const BitBoard& other) {
+		uint64_t* a = words();
+		const uint64_t* b = other.words();
+		for (int i = 0; i < _words; ++i) a[i] |= b[i];
+		return *this;
+	}
+
+	BitBoard& operator&=(const BitBoard& other) {
+		uint64_t* a = words();
+		const uint64_t* b = other.words();
+		for (int i = 0; i < _words; ++i) a[i] &= b[i];
+		return *this;
+	}
+
+	bool operator==(const BitBoard& other) const {
+		if (_bits != other._bits) return false;
+		const uint64_t* a = words();
+		const uint64_t* b = other.words();
+		for (int i = 0; i < _words; ++i) {
+			if (a[i] != b[i]) return false;
+		}
+		return true;
+	}
+};
@@ -1,28 +1,176 @@
 ﻿#pragma once
 
+enum class AttackOutcome : uint8_t {
+	Miss,
+	Hit,
+	Sunk,       // Vuruş gəminin son hüceyrəsinə düşdü
+	Rejected    // Lövhədən kənar və ya artıq atəş açılmış hüceyrə
+};
+
+// What a shot did. ship and length are the ship a Sunk shot finished - its
+// index on the board and its length; other outcomes leave them at -1 and 0,
+// so a plain hit does not give away which ship it was.
+struct AttackResult {
+	AttackOutcome outcome = AttackOutcome::Miss;
+	short ship = -1;
+	short length = 0;
+
+	bool isHit() const {
+		return outcome == AttackOutcome::Hit || outcome == AttackOutcome::Sunk;
+	}
+
+	bool isSunk() const {
+		return outcome == AttackOutcome::Sunk;
+	}
+};
+
 class Board {
 private:
 	int _size;
-	vector<vector<char>> _board;
 	vector<Ship> _ships;
+	CellArray<short> _shipAt; // Hüceyrədəki gəminin _ships indeksi, boşdursa -1
+	int _cellsAfloat;       // Bütün donanmada vurulmamış gəmi hüceyrələri
+	int _shipsAfloat;       // Batmamış gəmilərin sayı
+	EventRing* _events;     // nullptr - hadisələr heç yerə getmir (headless)
+	int _seat;              // Hadisələrdə bu lövhənin sahibi
+
+	// Board layers, one bit per cell
+	BitBoard _shipMask;
+	BitBoard _hitMask;
+	BitBoard _missMask;
+	BitBoard _haloMask; // Gəmilər və onların ətrafı - yeni gəmi qoyula bilməz
+
+	int cellIndex(int x, int y) const {
+		return y * _size + x;
+	}
+
+	// Resolves a shot at cell i, which has not been fired at before
+	AttackResult strike(int i, const Point& point) {
+		int id = _shipAt[i];
+		if (id < 0) {
+			_missMask.set(i);
+			EventRing::emit(_events, GameEventType::Miss, _seat, point.getX(), point.getY());
+			return AttackResult{ AttackOutcome::Miss };
+		}
+
+		_hitMask.set(i);
+		EventRing::emit(_events, GameEventType::Hit, _seat, point.getX(), point.getY(), id);
+		if (_ships[id].registerHit(point)) {
+			--_cellsAfloat;
+			if (_ships[id].isSunk()) {
+				--_shipsAfloat;
+				EventRing::emit(_events, GameEventType::ShipSunk, _seat, point.getX(), point.getY(), id, _ships[id].getLength());
+				if (_cellsAfloat == 0) EventRing::emit(_events, GameEventType::GameOver, 1 - _seat);
+				return AttackResult{ AttackOutcome::Sunk, static_cast<short>(id), static_cast<short>(_ships[id].getLength()) };
+			}
+		}
+		return AttackResult{ AttackOutcome::Hit };
+	}
+
+	bool inBounds(Point start, int length, bool horizontal) const {
+		if (length <= 0 || !isValid(start)) return false;
+		int endX = start.getX() + (horizontal ? length - 1 : 0);
+		int endY = start.getY() + (horizontal ? 0 : length - 1);
+		return endX < _size && endY < _size;
+	}
+
+	void markShip(Point start, int length, bool horizontal) {
+		int x = start.getX();
+		int y = start.getY();
+		short id = static_cast<short>(_ships.size());
+
+		for (int i = 0; i < length; ++i) {
+			_shipAt[cellIndex(x + (horizontal ? i : 0), y + (horizontal ? 0 : i))] = id;
+		}
+		_cellsAfloat += length;
+		_shipsAfloat++;
+
+		if (horizontal) {
+			_shipMask.setRange(cellIndex(x, y), length);
+
+			// Halo: rows y-1..y+1, columns x-1..x+length
+			int fromX = max(x - 1, 0);
+			int toX = min(x + length, _size - 1);
+			for (int row = max(y - 1, 0); row <= min(y + 1, _size - 1); ++row) {
+				_haloMask.setRange(cellIndex(fromX, row), toX - fromX + 1);
+			}
+		}
+		else {
+			int fromX = max(x - 1, 0);
+			int toX = min(x + 1, _size - 1);
+			for (int i = 0; i < length; ++i) {
+				_shipMask.set(cellIndex(x, y + i));
+			}
+			for (int row = max(y - 1, 0); row <= min(y + length, _size - 1); ++row) {
+				_haloMask.setRange(cellIndex(fromX, row), toX - fromX + 1);
+			}
+		}
+	}
 
 public:
-	Board(int size = 6) : _size(size), _board(_size, vector<char>(size, '#')) {}
+	Board(int size = 6)
+		: _size(size), _shipAt(size * size, -1), _cellsAfloat(0), _shipsAfloat(0), _events(nullptr), _seat(0),
+		_shipMask(size * size), _hitMask(size * size),
+		_missMask(size * size), _haloMask(size * size) {
+	}
 
 	int getBoardSize() const {
 		return _size;
 	}
 
+	// Ships in the order they were placed
+	const vector<Ship>& getShips() const {
+		return _ships;
+	}
+
+	// Bit layers and ship lookup, for code that snapshots the board
+	const BitBoard& getShipMask() const {
+		return _shipMask;
+	}
+
+	const BitBoard& getHitMask() const {
+		return _hitMask;
+	}
+
+	const BitBoard& getMissMask() const {
+		return _missMask;
+	}
+
+	int getShipAt(int cell) const {
+		return _shipAt[cell];
+	}
+
+	// Ships not yet sunk - the salvo size of the player who owns this board
+	int getShipsAfloat() const {
+		return _shipsAfloat;
+	}
+
+	// Shots on this board are reported to events as the given seat's board
+	void setEvents(EventRing* events, int seat) {
+		_events = events;
+		_seat = seat;
+	}
+
 	char getCell(int x, int y) const {
 		if (x >= 0 && x < getBoardSize() && y >= 0 && y < getBoardSize()) {
-			return _board[y][x];
+			int i = cellIndex(x, y);
+			if (_hitMask.test(i)) return 'H';
+			if (_missMask.test(i)) return 'M';
+			if (_shipMask.test(i)) return 'S';
+			return '#';
 		}
 		return ' ';
 	}
 
 	void reset() {
-		_board = vector<vector<char>>(_size, vector<char>(_size, '#'));
+		_shipMask.clear();
+		_hitMask.clear();
+		_missMask.clear();
+		_haloMask.clear();
 		_ships.clear();
+		_shipAt.fill(-1);
+		_cellsAfloat = 0;
+		_shipsAfloat = 0;
 	}
 
 	bool isValid(const Point& p) const {
@@ -30,42 +178,24 @@ public:
 	}
 
 	bool canPlaceShip(const Ship& ship) const {
-		for (const Point& p : ship.getOccupiedPoints()) {
-			if (!isValid(p)) return false;
-			if (_board[p.getY()][p.getX()] != '#') return false;
-
-			// Ətraf hüceyrələri yoxla
-			for (int dx = -1; dx <= 1; ++dx) {
-				for (int dy = -1; dy <= 1; ++dy) {
-					int nx = p.getX() + dx;
-					int ny = p.getY() + dy;
-					if (isValid(Point(nx, ny)) && _board[ny][nx] != '#') {
-						return false;
-					}
-				}
-			}
-		}
-		return true;
+		return canPlaceShip(ship.getStart(), ship.getLength(), ship.isHorizontal());
 	}
 
 
 	bool canPlaceShip(Point start, int length, bool horizontal) const {
+		if (!inBounds(start, length, horizontal)) return false;
+
+		int first = cellIndex(start.getX(), start.getY());
+		if (horizontal) {
+			return !_haloMask.anyInRange(first, length) &&
+				!_hitMask.anyInRange(first, length) &&
+				!_missMask.anyInRange(first, length);
+		}
+
 		for (int i = 0; i < length; ++i) {
-			int x = start.getX() + (horizontal ? i : 0);
-			int y = start.getY() + (horizontal ? 0 : i);
-			Point p(x, y);
-
-			if (!isValid(p)) return false;
-			if (_board[y][x] != '#') return false;
-
-			for (int dx = -1; dx <= 1; ++dx) {
-				for (int dy = -1; dy <= 1; ++dy) {
-					int nx = x + dx;
-					int ny = y + dy;
-					if (isValid(Point(nx, ny)) && _board[ny][nx] != '#') {
-						return false;
-					}
-				}
+			int cell = first + i * _size;
+			if (_haloMask.test(cell) || _hitMask.test(cell) || _missMask.test(cell)) {
+				return false;
 			}
 		}
 		return true;
@@ -74,56 +204,107 @@ public:
 
 	bool placeShip(const Ship& ship) {
 		if (!canPlaceShip(ship)) return false;
-		for (const Point& p : ship.getOccupiedPoints()) {
-			_board[p.getY()][p.getX()] = 'S';
-		}
+		markShip(ship.getStart(), ship.getLength(), ship.isHorizontal());
 		_ships.push_back(ship);
 		return true;
 	}
 
 	bool placeShip(Point start, int length, bool horizontal) {
 		if (!canPlaceShip(start, length, horizontal)) return false;
+		markShip(start, length, horizontal);
+		_ships.push_back(Ship(start, horizontal, length));
+		return true;
+	}
 
-		vector<Point> occupiedPoints;
-		for (int i = 0; i < length; ++i) {
-			int x = start.getX() + (horizontal ? i : 0);
-			int y = start.getY() + (horizontal ? 0 : i);
-			_board[y][x] = 'S';
-			occupiedPoints.emplace_back(x, y);
-		}
+	AttackResult attack(const Point& point) {
+		Metrics::count(Counter::BoardAttacks);
+		EventRing::emit(_events, GameEventType::ShotFired, _seat, point.getX(), point.getY());
 
-		Ship ship(start, horizontal, length);
-		ship.setOccupiedPoints(occupiedPoints);
-		_ships.push_back(ship);
+		if (!isValid(point)) {
+			EventRing::emit(_events, GameEventType::ShotRejected, _seat, point.getX(), point.getY());
+			return AttackResult{ AttackOutcome::Rejected };
+		}
 
-		return true;
+		int i = cellIndex(point.getX(), point.getY());
+		if (_hitMask.test(i) || _missMask.test(i)) {
+			EventRing::emit(_events, GameEventType::ShotRejected, _seat, point.getX(), point.getY());
+			return AttackResult{ AttackOutcome::Rejected };
+		}
+		return strike(i, point);
 	}
 
-	bool attack(const Point& point) {
-		int x = point.getX();
-		int y = point.getY();
+	// A whole salvo in one pass: bit i of the result is set when shots[i]
+	// hit. Shots off the board or on a cell already fired at (including
+	// earlier in the same salvo) count as misses. If results is given,
+	// results[i] gets what attack() would have returned for shots[i].
+	uint64_t attackBatch(span<const Point> shots, span<AttackResult> results = {}) {
+		if (shots.size() > 64) throw invalid_argument("A salvo holds at most 64 shots");
+		if (!results.empty() && results.size() < shots.size()) throw invalid_argument("One result per shot is needed");
+		Metrics::count(Counter::BoardAttacks, shots.size());
+
+		uint64_t hits = 0;
+		for (size_t s = 0; s < shots.size(); ++s) {
+			const Point& point = shots[s];
+			EventRing::emit(_events, GameEventType::ShotFired, _seat, point.getX(), point.getY());
+
+			int i = isValid(point) ? cellIndex(point.getX(), point.getY()) : -1;
+			if (i < 0 || _hitMask.test(i) || _missMask.test(i)) {
+				EventRing::emit(_events, GameEventType::ShotRejected, _seat, point.getX(), point.getY());
+				if (!results.empty()) results[s] = AttackResult{ AttackOutcome::Rejected };
+				continue;
+			}
+			AttackResult result = strike(i, point);
+			if (result.isHit()) hits |= 1ULL << s;
+			if (!results.empty()) results[s] = result;
+		}
+		return hits;
+	}
 
-		if (x < 0 || x >= _size || y < 0 || y >= _size) {
-			cout << "Invalid attack coordinates!" << endl;
-			return false;
+	// Save/resume: the fleet, then the hit and miss bits
+	void write(BinaryWriter& out) const {
+		int maskBytes = (_size * _size + 7) / 8;
+		out.writeVarint(static_cast<uint64_t>(_size));
+		out.writeVarint(_ships.size());
+		for (const Ship& ship : _ships) {
+			out.writeVarint(static_cast<uint64_t>(cellIndex(ship.getStart().getX(), ship.getStart().getY())));
+			out.writeU8(static_cast<uint8_t>((ship.getLength() << 1) | (ship.isHorizontal() ? 1 : 0)));
 		}
+		out.writeBits(_hitMask, maskBytes);
+		out.writeBits(_missMask, maskBytes);
+	}
 
-		if (_board[y][x] == 'H' || _board[y][x] == 'M') {
-			cout << "Already attacked here!" << endl;
-			return false;
+	// Puts back what write() saved; the fleet goes through placeShip(), so a
+	// damaged file cannot leave overlapping ships or hits on empty water
+	void read(BinaryReader& in) {
+		int cells = _size * _size;
+		int maskBytes = (cells + 7) / 8;
+		if (in.readVarint() != static_cast<uint64_t>(_size)) throw runtime_error("Saved board is a different size");
+
+		reset();
+		uint64_t count = in.readVarint();
+		if (count > static_cast<uint64_t>(cells)) throw runtime_error("Corrupt fleet in saved board");
+		for (uint64_t i = 0; i < count; ++i) {
+			uint64_t cell = in.readVarint();
+			uint8_t shape = in.readU8();
+			if (cell >= static_cast<uint64_t>(cells) ||
+				!placeShip(Point(static_cast<int>(cell % _size), static_cast<int>(cell / _size)), shape >> 1, (shape & 1) != 0)) {
+				throw runtime_error("Corrupt fleet in saved board");
+			}
 		}
 
-		for (auto& ship : _ships) {
-			if (ship.isHit(point)) {
-				ship.registerHit(point);
-				_board[y][x] = 'H';
-				cout << "Hit!" << endl;
-				return true;
+		in.readBits(_hitMask, maskBytes);
+		in.readBits(_missMask, maskBytes);
+		for (int c = 0; c < cells; ++c) {
+			int id = _shipAt[c];
+			bool hit = _hitMask.test(c);
+			if (_missMask.test(c) && (hit || id >= 0)) throw runtime_error("Corrupt shots in saved board");
+			if (!hit) continue;
+			if (id < 0) throw runtime_error("Corrupt shots in saved board");
+			if (_ships[id].registerHit(Point(c % _size, c / _size))) {
+				--_cellsAfloat;
+				if (_ships[id].isSunk()) --_shipsAfloat;
 			}
 		}
-		_board[y][x] = 'M';
-		cout << "Miss!" << endl;
-		return false;
 	}
 
 	void display(bool hideShips = true, bool hideMisses = false) const {
@@ -136,7 +317,7 @@ public:
 		for (int row = 0; row < _size; ++row) {
 			cout << row << " ";
 			for (int col = 0; col < _size; ++col) {
-				char cell = _board[row][col];
+				char cell = getCell(col, row);
 				if (cell == 'S' && hideShips) {
 					cout << ";";// Gəmiləri gizlə
 				}
@@ -152,11 +333,6 @@ public:
 	}
 
 	bool allShipsSunk() const {
-		for (const auto& ship : _ships) {
-			if (!ship.isSunk()) {
-				return false;
-			}
-		}
-		return true;
+		return _cellsAfloat == 0;
 	}
 };
\ No newline at end of file
@@ -0,0 +1,181 @@
+#pragma once
+
+
+// Neighbours of one cell as cell indices, -1 where the board ends
+struct CellNeighbours {
+	short orthogonal[4];    // Yuxarı, aşağı, sol, sağ
+	short diagonal[4];
+};
+
+// The neighbours of (x, y) in the order every neighbour table uses: up,
+// down, left, right, then the diagonals
+constexpr CellNeighbours cellNeighbours(int size, int x, int y) {
+	const int dx[] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+	const int dy[] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	auto at = [&](int d) -> short {
+		int nx = x + dx[d], ny = y + dy[d];
+		return (nx >= 0 && nx < size && ny >= 0 && ny < size) ? static_cast<short>(ny * size + nx) : -1;
+	};
+	CellNeighbours n = {};
+	for (int d = 0; d < 4; ++d) {
+		n.orthogonal[d] = at(d);
+		n.diagonal[d] = at(d + 4);
+	}
+	return n;
+}
+
+// Calls visit(x, y, horizontal) for every placement of one length,
+// by row, then column, horizontal before vertical. Every placement table
+// numbers placements in this order, length by length.
+template <class Visit>
+constexpr void forEachPlacement(int size, int length, Visit&& visit) {
+	for (int y = 0; y < size; ++y) {
+		for (int x = 0; x < size; ++x) {
+			if (x + length <= size) visit(x, y, true);
+			if (length > 1 && y + length <= size) visit(x, y, false);
+		}
+	}
+}
+
+// Compile-time game configuration: board size and fleet. Tables that only
+// depend on these are generated as constexpr data, so for the standard game
+// they sit in static storage and are never built at run time.
+template <int Size, class FleetT>
+struct BoardConfig {
+	static_assert(Size >= 1 && Size * Size <= 32767, "Cell indices must fit in a short");
+	static_assert(FleetT::longest() <= Size, "Every ship must fit on the board");
+	static_assert(FleetT::isLongestFirst(), "Fleets are listed longest ship first");
+
+	static constexpr int SIZE = Size;
+	static constexpr int CELLS = Size * Size;
+	static constexpr int WORDS = (CELLS + 63) / 64;  // Hüceyrə maskasında 64-bitlik söz sayı
+	typedef FleetT FleetType;
+
+	static constexpr int placementsOfLength(int length) {
+		return length == 1 ? CELLS : 2 * Size * (Size - length + 1);
+	}
+
+	static constexpr int countPlacements() {
+		int total = 0;
+		for (int length = 1; length <= FleetT::longest(); ++length) total += placementsOfLength(length);
+		return total;
+	}
+
+	static constexpr int PLACEMENTS = countPlacements();
+
+	// Placements are numbered as in PlacementTable(SIZE, longest ship):
+	// by length, then in forEachPlacement() order. Those of one length are
+	// [lengthFirst[length], lengthFirst[length + 1]).
+	struct Tables {
+		CellNeighbours neighbours[CELLS];
+		uint64_t cellMasks[PLACEMENTS][WORDS];
+		uint64_t haloMasks[PLACEMENTS][WORDS];
+		short lengthFirst[FleetT::longest() + 2];
+		uint64_t startMasks[FleetT::longest() + 1][2][WORDS];  // [uzunluq][0 - üfüqi, 1 - şaquli] başlanğıc hüceyrələri
+		short placementAt[FleetT::longest() + 1][2][CELLS];    // Başlanğıc hüceyrə -> yerləşmə
+	};
+
+	static constexpr void addPlacement(Tables& t, int p, int x, int y, int length, bool horizontal) {
+		int endX = x + (horizontal ? length - 1 : 0);
+		int endY = y + (horizontal ? 0 : length - 1);
+		int start = y * Size + x;
+		t.startMasks[length][horizontal ? 0 : 1][start >> 6] |= 1ULL << (start & 63);
+		t.placementAt[length][horizontal ? 0 : 1][start] = static_cast<short>(p);
+		for (int i = 0; i < length; ++i) {
+			int cell = (y + (horizontal ? 0 : i)) * Size + x + (horizontal ? i : 0);
+			t.cellMasks[p][cell >> 6] |= 1ULL << (cell & 63);
+		}
+		for (int hy = (y > 0 ? y - 1 : 0); hy <= (endY + 1 < Size ? endY + 1 : Size - 1); ++hy) {
+			for (int hx = (x > 0 ? x - 1 : 0); hx <= (endX + 1 < Size ? endX + 1 : Size - 1); ++hx) {
+				int cell = hy * Size + hx;
+				t.haloMasks[p][cell >> 6] |= 1ULL << (cell & 63);
+			}
+		}
+	}
+
+	static constexpr Tables makeTables() {
+		Tables t = {};
+		int p = 0;
+		for (int length = 1; length <= FleetT::longest(); ++length) {
+			t.lengthFirst[length] = static_cast<short>(p);
+			forEachPlacement(Size, length, [&](int x, int y, bool horizontal) {
+				addPlacement(t, p++, x, y, length, horizontal);
+			});
+		}
+		t.lengthFirst[FleetT::longest() + 1] = static_cast<short>(p);
+
+		for (int c = 0; c < CELLS; ++c) t.neighbours[c] = cellNeighbours(Size, c % Size, c / Size);
+		return t;
+	}
+
+	static constexpr Tables tables = makeTables();
+};
+
+template <int Size, class FleetT>
+constexpr typename BoardConfig<Size, FleetT>::Tables BoardConfig<Size, FleetT>::tables;
+
+typedef BoardConfig<STANDARD_BOARD_SIZE, StandardFleet> StandardConfig;
+
+
+// One value per cell for a board size chosen at run time. Boards up to
+// Config's size keep them in a fixed array - for StandardConfig the 10x10
+// game never touches the heap - and larger boards fall back to a vector.
+template <class T, class Config = StandardConfig>
+class CellArray {
+private:
+	int _cells;
+	T _inline[Config::CELLS];
+	vector<T> _heap;
+
+public:
+	CellArray(int cells, T value) : _cells(cells) {
+		if (_cells > Config::CELLS) _heap.resize(_cells);
+		fill(value);
+	}
+
+	T* data() { return _cells <= Config::CELLS ? _inline : _heap.data(); }
+	const T* data() const { return _cells <= Config::CELLS ? _inline : _heap.data(); }
+	int size() const { return _cells; }
+
+	T& operator[](int cell) { return data()[cell]; }
+	const T& operator[](int cell) const { return data()[cell]; }
+
+	void fill(T value) {
+		std::fill(data(), data() + _cells, value);
+	}
+};
+
+
+// Neighbour lookup for a board size chosen at run time. The standard size
+// reads StandardConfig's constexpr table; any other size gets the same
+// table built once and shared.
+class NeighbourTable {
+private:
+	vector<CellNeighbours> _built;
+	const CellNeighbours* _cells;
+
+	explicit NeighbourTable(int size) {
+		if (size == StandardConfig::SIZE) {
+			_cells = StandardConfig::tables.neighbours;
+			return;
+		}
+
+		_built.resize(size * size);
+		for (int c = 0; c < size * size; ++c) _built[c] = cellNeighbours(size, c % size, c / size);
+		_cells = _built.data();
+	}
+
+public:
+	static const NeighbourTable& get(int size) {
+		static mutex cacheMutex;
+		static map<int, unique_ptr<NeighbourTable>> cache;
+
+		lock_guard<mutex> lock(cacheMutex);
+		unique_ptr<NeighbourTable>& table = cache[size];
+		if (!table) table.reset(new NeighbourTable(size));
+		return *table;
+	}
+
+	const short* orthogonal(int cell) const { return _cells[cell].orthogonal; }
+	const short* diagonal(int cell) const { return _cells[cell].diagonal; }
+};
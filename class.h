@@ -1,12 +1,9 @@
 ﻿#pragma once
 
-#include "constants.h"
-#include "point.h"
-#include "ship.h"
-#include "board.h"
-#include "playerBase.h"
+#include "engine.h"
+#include "renderer.h"
+#include "terminal.h"
 #include "humanPlayer.h"
-#include "computerPlayer.h"
 
 
 
@@ -16,27 +13,111 @@ private:
 	Player* _player2;
 	bool _isAgainstComputer;
 	bool _isComputerVsComputer;
+	string _recordPath;      // Boş deyilsə oyun bu arxivə yazılır
+	bool _metricsOverlay;    // Lövhələrin altında metrikalar
+	bool _salvo;             // Hər batmamış gəmi üçün bir atəş, növbə hər dəfə keçir
+	EventRing _events;       // Oyunçuların və lövhələrin hadisələri, hər növbədən sonra oxunur
+	string _status;          // Son növbənin hadisələri, lövhələrin altında
+	int _mode;               // getGameMode() seçimi
+	Difficulty _difficulty;
+	uint64_t _seed;
+	string _savePath;        // S/Q düyməsi oyunu bura yazır
+	string _resumePath;      // Boş deyilsə start() menyu əvəzinə bu faylı açır
+	bool _quit;              // Oyunçu yadda saxlayıb çıxdı
+	SaveWriter _saver;
+
+	// Players start() hands out, built on first use and reset in place for later games
+	unique_ptr<HumanPlayer> _humans[2];
+	unique_ptr<ComputerPlayer> _computers[2];
+
+	HumanPlayer* human(int seat) {
+		if (_humans[seat]) _humans[seat]->reset();
+		else {
+			Board board(STANDARD_BOARD_SIZE);
+			_humans[seat].reset(new HumanPlayer(board));
+		}
+		return _humans[seat].get();
+	}
+
+	ComputerPlayer* computer(int seat) {
+		if (_computers[seat]) _computers[seat]->reset();
+		else {
+			Board board(STANDARD_BOARD_SIZE);
+			_computers[seat].reset(new ComputerPlayer(board, AIStrategy::MonteCarlo));
+		}
+		return _computers[seat].get();
+	}
+
+	// What the players are told about an event; empty for the ones not shown
+	static string describe(const GameEvent& event) {
+		switch (event.type) {
+		case GameEventType::Hit: return "Hit!";
+		case GameEventType::Miss: return "Miss!";
+		case GameEventType::ShotRejected: return "Already attacked here!";
+		case GameEventType::ShipSunk: return "Ship of length " + to_string(event.length) + " sunk!";
+		case GameEventType::FleetPlaced: return "Computer's ships placed!";
+		case GameEventType::PlacementFailed: return "Warning: Could not place the fleet";
+		default: return string();
+		}
+	}
+
+	// Everything reported since the last call, as one line
+	string drainEvents() {
+		string text;
+		_events.drain([&](const GameEvent& event) {
+			string line = describe(event);
+			if (line.empty()) return;
+			if (!text.empty()) text += "  ";
+			text += line;
+		});
+		return text;
+	}
 
-	// Set text color (Windows specific)
+	// Set text color (console attribute number, sent as an ANSI escape)
 	void setColor(int color) {
-		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color);
+		cout << ConsoleRenderer::ansiColor(color);
 	}
 
 	// Reset to default color
 	void resetColor() {
-		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+		cout << ConsoleRenderer::ansiColor(7);
 	}
 
-	// Typewriter effect with color
+	// Typewriter effect with color; any key prints the rest at once
 	void typeText(const string& text, int color = 7, int delayMs = 7) {
 		setColor(color);
-		for (char c : text) {
-			cout << c << flush;
-			Sleep(delayMs);
+		for (size_t i = 0; i < text.size(); ++i) {
+			cout << text[i] << flush;
+			if (Terminal::shared().waitForKey(delayMs)) {
+				cout << text.substr(i + 1) << flush;
+				break;
+			}
 		}
 		resetColor();
 	}
 
+	// Y/N prompt answered with a single key. Input ending counts as yes and
+	// sets _quit, so the caller can stop before anything else is asked.
+	bool askYesNo(const string& question) {
+		cout << question << " (Y/N): " << flush;
+		while (true) {
+			int key = Terminal::shared().readKey();
+			if (key == KEY_EOF) {
+				cout << endl;
+				_quit = true;
+				return true;
+			}
+			if (key == 'y' || key == 'Y' || key == '1') {
+				cout << "Yes" << endl;
+				return true;
+			}
+			if (key == 'n' || key == 'N' || key == '0') {
+				cout << "No" << endl;
+				return false;
+			}
+		}
+	}
+
 	// Handle user input for selecting attack with the cursor
 	Point selectAttackWithCursor(Player* currentPlayer) {
 		Point cursor(0, 0);
@@ -46,14 +127,19 @@ private:
 			displayDualBoards(cursor); // Show the boards with the cursor highlight
 
 			if (_isAgainstComputer && currentPlayer == _player1) {
-				cout << "\nUse arrow keys to move, ENTER to attack, ESC to cancel\n";
+				cout << "\nUse arrow keys to move, ENTER to attack, S to save, Q to save and quit, ESC to cancel\n";
 			}
 			else if (!_isAgainstComputer && !_isComputerVsComputer) {
 				cout << "\nPLAYER " << (currentPlayer == _player1 ? "1" : "2")
-					<< ": Use arrow keys to move, ENTER to attack, ESC to cancel\n";
+					<< ": Use arrow keys to move, ENTER to attack, S to save, Q to save and quit, ESC to cancel\n";
 			}
 
-			int c = _getch();
+			int c = Terminal::shared().readKey();
+			if (endOfInput(c, currentPlayer)) return Point(-1, -1);
+			if (saveKey(c, currentPlayer)) {
+				if (_quit) return Point(-1, -1);
+				continue;
+			}
 			switch (c) {
 			case KEY_UP:
 				if (cursor.getY() > 0) cursor.decrementY();
@@ -73,8 +159,8 @@ private:
 					return cursor;
 				}
 				else {
-					cout << "You already attacked here! Try another position!";
-					Sleep(1000);
+					cout << refusalText(currentPlayer->getAttackBoard()[cursor.getY()][cursor.getX()]) << flush;
+					Terminal::shared().waitForKey(1000);
 				}
 				break;
 			case ESC:
@@ -83,88 +169,255 @@ private:
 				break;
 			}
 		}
+		return Point(-1, -1);
+	}
+
+	// Encodes the game as it stands - a few microseconds - and leaves the
+	// file write to a background thread. shooter is the player to move.
+	void saveGame(Player* shooter) {
+		SavedGame saved;
+		saved.mode = _mode;
+		saved.difficulty = static_cast<int>(_difficulty);
+		saved.salvo = _salvo;
+		saved.shooter = shooter == _player1 ? 0 : 1;
+		saved.seed = _seed;
+
+		BinaryWriter snapshot;
+		saved.writeHeader(snapshot);
+		_player1->saveState(snapshot);
+		_player2->saveState(snapshot);
+		try {
+			_saver.write(_savePath, snapshot.data());
+			_status = "Game saved to " + _savePath + " - resume with --resume " + _savePath;
+		}
+		catch (const exception& e) {
+			_status = string("Save failed: ") + e.what();
+		}
+	}
+
+	// Nobody is left to press a key: the game is saved and left as Q would
+	bool endOfInput(int key, Player* shooter) {
+		if (key != KEY_EOF) return false;
+		saveGame(shooter);
+		_quit = true;
+		return true;
+	}
+
+	// Why a cell on the attack board cannot be fired at
+	static string refusalText(char cell) {
+		if (cell == '.') return "No ship can be there - it would touch a sunk one!";
+		return "You already attacked here! Try another position!";
 	}
 
-	// Display the boards of both players side by side
-	void displayDualBoards(const Point& cursor = Point(-1, -1)) {
-		system("cls||clear");
+	// S saves, Q saves and quits; true if the key was one of them
+	bool saveKey(int key, Player* shooter) {
+		if (key != 's' && key != 'S' && key != 'q' && key != 'Q') return false;
+		saveGame(shooter);
+		_quit = key == 'q' || key == 'Q';
+		return true;
+	}
+
+	// Salvo aiming: ENTER marks a cell (again to unmark); the salvo fires
+	// once count cells are marked. Empty if the player pressed ESC.
+	vector<Point> selectSalvoWithCursor(Player* currentPlayer, int count) {
+		const vector<vector<char>>& attackBoard = currentPlayer->getAttackBoard();
+		int size = currentPlayer->getBoard().getBoardSize();
+		int open = 0;
+		for (const auto& row : attackBoard) open += static_cast<int>(std::count(row.begin(), row.end(), '#'));
+		count = min(count, open);
+
+		Point cursor(0, 0);
+		vector<Point> marked;
+		while (static_cast<int>(marked.size()) < count) {
+			displayDualBoards(cursor, marked);
+			cout << "\n" << (_isAgainstComputer ? string() : "PLAYER " + string(currentPlayer == _player1 ? "1" : "2") + ": ")
+				<< "Use arrow keys to move, ENTER to mark (" << count - marked.size() << " left), S to save, Q to save and quit, ESC to cancel\n";
+
+			int c = Terminal::shared().readKey();
+			if (endOfInput(c, currentPlayer)) return vector<Point>();
+			if (saveKey(c, currentPlayer)) {
+				if (_quit) return vector<Point>();
+				continue;
+			}
+			switch (c) {
+			case KEY_UP:
+				if (cursor.getY() > 0) cursor.decrementY();
+				break;
+			case KEY_DOWN:
+				if (cursor.getY() < size - 1) cursor.incrementY();
+				break;
+			case KEY_LEFT:
+				if (cursor.getX() > 0) cursor.decrementX();
+				break;
+			case KEY_RIGHT:
+				if (cursor.getX() < size - 1) cursor.incrementX();
+				break;
+			case ENTER_KEY: {
+				auto at = find_if(marked.begin(), marked.end(), [&](const Point& p) {
+					return p.getX() == cursor.getX() && p.getY() == cursor.getY();
+				});
+				if (at != marked.end()) marked.erase(at);
+				else if (attackBoard[cursor.getY()][cursor.getX()] == '#') marked.push_back(cursor);
+				else {
+					cout << refusalText(attackBoard[cursor.getY()][cursor.getX()]) << flush;
+					Terminal::shared().waitForKey(1000);
+				}
+				break;
+			}
+			case ESC:
+				return vector<Point>();
+			default:
+				break;
+			}
+		}
+		return marked;
+	}
+
+	// Display the boards of both players side by side; marked cells are a salvo being aimed
+	void displayDualBoards(const Point& cursor = Point(-1, -1), const vector<Point>& marked = vector<Point>()) {
+		ConsoleRenderer& screen = ConsoleRenderer::shared();
+		screen.beginFrame();
 
 		Board& board1 = _player1->getBoard();
 		Board& board2 = _player2->getBoard();
+		const vector<vector<char>>& excluded = _player1->getAttackBoard(); // Batmış gəmilərin ətrafı
 		int size = board1.getBoardSize();
 
 		// Display headers
-		setColor(11); // Cyan for "YOUR FLEET"
-		cout << "  YOUR FLEET";
-		cout << string(size * 3 - 10, ' ');
-		setColor(12); // Red for "ENEMY TERRITORY"
-		cout << "ENEMY TERRITORY\n";
-		resetColor();
+		int x = screen.text(0, 0, "  YOUR FLEET", 11);               // Cyan for "YOUR FLEET"
+		screen.text(x + size * 3 - 10, 0, "ENEMY TERRITORY", 12);    // Red for "ENEMY TERRITORY"
 
 		// Display column numbers for both boards
-		cout << "   ";
-		for (int i = 0; i < size; ++i) cout << setw(2) << i << " ";
-		cout << "       ";
-		for (int i = 0; i < size; ++i) cout << setw(2) << i << " ";
-		cout << endl;
+		x = 3;
+		for (int i = 0; i < size; ++i) x = screen.number(x, 1, i, 2) + 1;
+		x += 7;
+		for (int i = 0; i < size; ++i) x = screen.number(x, 1, i, 2) + 1;
 
 		// Display the boards row by row
 		for (int y = 0; y < size; ++y) {
+			int row = y + 2;
+
 			// Player 1's board (left)
-			setColor(11); // Cyan for row numbers
-			cout << setw(2) << y << " ";
-			resetColor();
-			for (int x = 0; x < size; ++x) {
-				char cell = board1.getCell(x, y);
-				if (cell == 'H') setColor(12);      // Hits - red
-				else if (cell == 'M') setColor(8);  // Misses - gray
-				else if (cell == 'S') setColor(10); // Ships - green (only visible after being hit)
-				cout << setw(2) << (cell == 'S' ? '#' : cell) << " "; // Show ships as water (~) until hit
-				resetColor();
+			x = screen.number(0, row, y, 2, 11) + 1; // Cyan for row numbers
+			for (int col = 0; col < size; ++col) {
+				char cell = board1.getCell(col, y);
+				int color = 7;
+				if (cell == 'H') color = 12;      // Hits - red
+				else if (cell == 'M') color = 8;  // Misses - gray
+				else if (cell == 'S') color = 10; // Ships - green (only visible after being hit)
+				screen.put(x + 1, row, cell == 'S' ? '#' : cell, color); // Show ships as water until hit
+				x += 3;
 			}
 
 			// Space between the two boards
-			cout << "   ";
+			x += 3;
 
 			// Player 2's board (right)
-			setColor(12); // Red for row numbers
-			cout << setw(3) << y << " ";
-			resetColor();
-			for (int x = 0; x < size; ++x) {
-				char cell = board2.getCell(x, y);
+			x = screen.number(x, row, y, 3, 12) + 1; // Red for row numbers
+			for (int col = 0; col < size; ++col) {
+				char cell = board2.getCell(col, y);
 
 				// Highlight cursor if it's on this cell
-				if (cursor.getX() == x && cursor.getY() == y) {
-					setColor(14); // Yellow background
-					setColor(12); // Red text
-					cout << " X ";  // Cursor symbol
-					resetColor();
+				if (cursor.getX() == col && cursor.getY() == y) {
+					screen.text(x, row, " X ", 12); // Cursor symbol
+				}
+				else if (any_of(marked.begin(), marked.end(), [&](const Point& p) { return p.getX() == col && p.getY() == y; })) {
+					screen.text(x, row, " * ", 14); // Salvo target
 				}
 				else {
-					if (cell == 'H') setColor(12);      // Hits - red
-					else if (cell == 'M') setColor(8);  // Misses - gray
-					else {
-						setColor(7);                   // Hidden or unexplored cells
-						cell = '#';                   // Hide opponent's ships
+					int color = 7;                    // Hidden or unexplored cells
+					if (cell == 'H') color = 12;      // Hits - red
+					else if (cell == 'M') color = 8;  // Misses - gray
+					else if (excluded[y][col] == '.') {
+						cell = '.';                   // Around a sunk ship - gray
+						color = 8;
 					}
-					cout << setw(2) << cell << " ";
-					resetColor();
+					else cell = '#';                  // Hide opponent's ships
+					screen.put(x + 1, row, cell, color);
 				}
+				x += 3;
 			}
-			cout << endl;
 		}
 
 		// Display legend
-		setColor(12); cout << "H"; resetColor(); cout << " Hit  ";
-		setColor(8); cout << "M"; resetColor(); cout << " Miss  ";
-		setColor(14); cout << "X"; resetColor(); cout << " Cursor\n";
+		int legend = size + 2;
+		x = screen.text(0, legend, "H", 12);
+		x = screen.text(x, legend, " Hit  ");
+		x = screen.text(x, legend, "M", 8);
+		x = screen.text(x, legend, " Miss  ");
+		x = screen.text(x, legend, ".", 8);
+		x = screen.text(x, legend, " Empty  ");
+		x = screen.text(x, legend, "X", 14);
+		x = screen.text(x, legend, " Cursor");
+		if (_salvo) {
+			x = screen.text(x, legend, "  ");
+			x = screen.text(x, legend, "*", 14);
+			screen.text(x, legend, " Salvo");
+		}
+
+		if (!_status.empty()) screen.text(0, legend + 1, _status, 14);
+		if (_metricsOverlay) drawMetrics(screen, legend + 2);
+
+		screen.present();
+	}
+
+	static string latency(const char* label, const HistogramData& data) {
+		ostringstream text;
+		text << fixed << setprecision(2) << label << " p50 " << data.quantileUs(0.5) / 1000
+			<< "ms p99 " << data.quantileUs(0.99) / 1000 << "ms";
+		return text.str();
+	}
+
+	// Histogram figures are bucket upper bounds, so they read as "under"
+	void drawMetrics(ConsoleRenderer& screen, int row) {
+		MetricsSnapshot m = Metrics::snapshot();
+		int x = screen.text(0, row, latency("frame", m.get(Histogram::RenderFrame)), 8);
+		x = screen.text(x, row, "   " + latency("key->frame", m.get(Histogram::KeyToFrame)), 8);
+		screen.text(x, row, "   " + latency("AI think", m.get(Histogram::AiThink)), 8);
+		screen.text(0, row + 1, "attacks " + to_string(m.get(Counter::BoardAttacks)) +
+			"   games " + to_string(m.get(Counter::GamesPlayed)) +
+			"   placement restarts " + to_string(m.get(Counter::PlacementRestarts)) +
+			"   keys " + to_string(m.get(Counter::KeysRead)), 8);
+	}
+
+	// Seats the players for a game mode (getGameMode() order) and connects them to the event ring
+	void seatPlayers(int mode, ComputerPlayer* computers[2]) {
+		_mode = mode;
+		switch (mode) {
+		case 0: // Player vs Player
+			_player1 = human(0);
+			_player2 = human(1);
+			_isComputerVsComputer = false;
+			_isAgainstComputer = false;
+			break;
+		case 1: // Player vs Computer
+			_player1 = human(0);
+			_player2 = computers[1] = computer(1);
+			_isComputerVsComputer = false;
+			_isAgainstComputer = true;
+			break;
+		case 2: // Computer vs Computer
+			_player1 = computers[0] = computer(0);
+			_player2 = computers[1] = computer(1);
+			_isComputerVsComputer = true;
+			_isAgainstComputer = false;
+			break;
+		default:
+			throw invalid_argument("Unknown game mode");
+		}
+
+		// Both players report to this game's ring, drained after every turn
+		_player1->setEvents(&_events, 0);
+		_player2->setEvents(&_events, 1);
+		drainEvents();
+		_status.clear();
 	}
 
 	// Get the game mode from the user
 	int getGameMode() {
 		int choice = 0;
 		while (true) {
-			system("cls||clear");
+			ConsoleRenderer::shared().clearScreen();
 			cout << "Select game mode: " << COLOR_RESET << endl;
 			cout << (choice == 0 ? COLOR_MAGENTA : COLOR_RESET) << "1. Player vs Player." << COLOR_RESET << endl;
 			cout << (choice == 1 ? COLOR_MAGENTA : COLOR_RESET) << "2. Player vs Computer." << COLOR_RESET << endl;
@@ -172,7 +425,7 @@ private:
 			cout << (choice == 3 ? COLOR_MAGENTA : COLOR_RESET) << "4. Exit game." << COLOR_RESET << endl;
 			cout << COLOR_RESET << endl;
 
-			int c = _getch();
+			int c = Terminal::shared().readKey();
 			switch (c) {
 			case KEY_UP:
 				choice = (choice > 0) ? choice - 1 : 2;
@@ -182,6 +435,38 @@ private:
 				break;
 			case ENTER_KEY:
 				return choice;
+			case KEY_EOF:
+				return 3; // Exit game
+			default:
+				break;
+			}
+		}
+	}
+
+	// Computer strength = how long it may search per move
+	Difficulty getDifficulty() {
+		int choice = 1;
+		while (true) {
+			ConsoleRenderer::shared().clearScreen();
+			cout << "Select computer difficulty: " << COLOR_RESET << endl;
+			cout << (choice == 0 ? COLOR_MAGENTA : COLOR_RESET) << "1. Easy." << COLOR_RESET << endl;
+			cout << (choice == 1 ? COLOR_MAGENTA : COLOR_RESET) << "2. Normal." << COLOR_RESET << endl;
+			cout << (choice == 2 ? COLOR_MAGENTA : COLOR_RESET) << "3. Hard." << COLOR_RESET << endl;
+			cout << COLOR_RESET << endl;
+
+			int c = Terminal::shared().readKey();
+			switch (c) {
+			case KEY_UP:
+				choice = (choice > 0) ? choice - 1 : 2;
+				break;
+			case KEY_DOWN:
+				choice = (choice < 2) ? choice + 1 : 0;
+				break;
+			case ENTER_KEY:
+				return choice == 0 ? Difficulty::Easy : (choice == 2 ? Difficulty::Hard : Difficulty::Normal);
+			case KEY_EOF:
+				_quit = true;
+				return Difficulty::Normal;
 			default:
 				break;
 			}
@@ -190,7 +475,7 @@ private:
 
    // Display the welcome message
 	void welcomeMessage() {
-		system("cls||clear");
+		ConsoleRenderer::shared().clearScreen();
 		setColor(11);
 		cout << R"(
                                              ___  ___ ______________   __________ _________ 
@@ -225,7 +510,8 @@ private:
 		typeText("The fate of your navy lies in your hands, Commander...\n\n", 11);
 
 		typeText("Press any key to launch your mission!\n\n", 14);
-		_getch();
+		Terminal::shared().flushInput();
+		Terminal::shared().readKey();
 	}
 
 
@@ -234,7 +520,93 @@ public:
 		: _player1(player1), _player2(player2),
 		_isAgainstComputer(dynamic_cast<ComputerPlayer*>(_player2) != nullptr),
 		_isComputerVsComputer(dynamic_cast<ComputerPlayer*>(_player1) != nullptr &&
-			dynamic_cast<ComputerPlayer*>(_player2) != nullptr) {
+			dynamic_cast<ComputerPlayer*>(_player2) != nullptr),
+		_metricsOverlay(false), _salvo(false), _mode(0), _difficulty(Difficulty::Normal), _seed(0),
+		_savePath("battleship.sav"), _quit(false) {
+	}
+
+	// Shows latency percentiles and engine counters under the boards (needs Metrics enabled)
+	void setMetricsOverlay(bool show) {
+		_metricsOverlay = show;
+	}
+
+	// Salvo rules: each turn fires one shot per ship still afloat, and the
+	// turn passes whatever they hit. Such games are not recorded.
+	void setSalvo(bool salvo) {
+		_salvo = salvo;
+	}
+
+	// Where S and Q save the game in progress
+	void setSavePath(const string& path) {
+		_savePath = path;
+	}
+
+	// start() picks up this saved game instead of showing the menus
+	void setResumePath(const string& path) {
+		_resumePath = path;
+	}
+
+	// Played games are appended to this archive (see GameArchiveWriter)
+	void setRecordPath(const string& path) {
+		_recordPath = path;
+	}
+
+	// Step through a recorded game: arrows step or jump, ENTER plays/pauses
+	void replay(const GameRecord& record, int startTurn = 0) {
+		GameReplay replay(record);
+		Player* saved[2] = { _player1, _player2 };
+		_player1 = &replay.getPlayer(0);
+		_player2 = &replay.getPlayer(1);
+
+		const int jump = 10;
+		bool playing = false;
+		replay.seek(startTurn);
+		ConsoleRenderer::shared().clearScreen();
+
+		while (true) {
+			displayDualBoards();
+			cout << "\nGame " << record.getGameIndex() << " (seed " << record.getSeed() << ")  turn "
+				<< replay.getTurn() << "/" << record.getShotCount();
+			if (replay.isFinished()) {
+				cout << "  -  " << (record.getWinner() < 0 ? "no winner" :
+					"Player " + to_string(record.getWinner() + 1) + " won");
+			}
+			else {
+				cout << "  -  Player " << replay.getShooter() + 1 << " to shoot";
+			}
+			cout << "\nLEFT/RIGHT step, UP/DOWN jump " << jump << ", ENTER play/pause, ESC quit" << flush;
+
+			int key = Terminal::shared().readKey(playing ? COMPUTER_MOVE_MS : -1);
+			if (key == Terminal::KEY_NONE) {
+				if (playing) playing = replay.step();
+				continue;
+			}
+			if (key == ESC || key == KEY_EOF) break;
+
+			switch (key) {
+			case KEY_RIGHT:
+				replay.step();
+				break;
+			case KEY_LEFT:
+				replay.seek(replay.getTurn() - 1);
+				break;
+			case KEY_UP:
+				replay.seek(replay.getTurn() + jump);
+				break;
+			case KEY_DOWN:
+				replay.seek(replay.getTurn() - jump);
+				break;
+			case ENTER_KEY:
+				playing = !playing && !replay.isFinished();
+				break;
+			default:
+				break;
+			}
+		}
+
+		cout << endl;
+		_player1 = saved[0];
+		_player2 = saved[1];
 	}
 
 	void reset() {
@@ -245,88 +617,146 @@ public:
 	void start() {
 		//welcomeMessage();
 
-		int choice = getGameMode();
-		if (choice == 3) {
-			typeText("\nExiting game. Goodbye!\n", 12);
-			return;
+		ComputerPlayer* computers[2] = { nullptr, nullptr };
+		int shooter = 0;
+		bool resumed = !_resumePath.empty();
+		_quit = false;
+
+		if (resumed) {
+			vector<uint8_t> data = SavedGame::readFile(_resumePath);
+			BinaryReader in(data.data(), data.size());
+			SavedGame saved;
+			saved.readHeader(in);
+			seatPlayers(saved.mode, computers);
+
+			_difficulty = static_cast<Difficulty>(saved.difficulty);
+			for (ComputerPlayer* computer : computers) {
+				if (computer) computer->setDifficulty(_difficulty);
+			}
+			_salvo = saved.salvo;
+			_seed = saved.seed;
+			shooter = saved.shooter;
+			_player1->loadState(in);
+			_player2->loadState(in);
+			_player1->checkKnowledge(_player2->getBoard());
+			_player2->checkKnowledge(_player1->getBoard());
 		}
+		else {
+			int choice = getGameMode();
+			if (choice == 3) {
+				typeText("\nExiting game. Goodbye!\n", 12);
+				return;
+			}
+			seatPlayers(choice, computers);
 
-		const int boardSize = 10;
-		auto board1 = make_shared<Board>(boardSize);
-		auto board2 = make_shared<Board>(boardSize);
+			if (_isAgainstComputer || _isComputerVsComputer) {
+				_difficulty = getDifficulty();
+				for (ComputerPlayer* computer : computers) {
+					if (computer) computer->setDifficulty(_difficulty);
+				}
+				if (_quit) {
+					typeText("\nExiting game. Goodbye!\n", 12);
+					return;
+				}
+			}
 
-		switch (choice) {
-		case 0: // Player vs Player
-			_player1 = new HumanPlayer(*board1);
-			_player2 = new HumanPlayer(*board2);
-			_isComputerVsComputer = false;
-			_isAgainstComputer = false;
-			break;
-		case 1: // Player vs Computer
-			_player1 = new HumanPlayer(*board1);
-			_player2 = new ComputerPlayer(*board2);
-			_isComputerVsComputer = false;
-			_isAgainstComputer = true;
-			break;
-		case 2: // Computer vs Computer
-			_player1 = new ComputerPlayer(*board1);
-			_player2 = new ComputerPlayer(*board2);
-			_isComputerVsComputer = true;
-			_isAgainstComputer = false;
-			break;
-		default:
-			return;
-		}
+			// One seed for both players, kept in the record
+			_seed = Rng().next();
+			Simulation::seedGame(*_player1, *_player2, _seed);
 
-		// Ship placement
-		if (_isComputerVsComputer) {
-			_player1->placeShips(true);
-			_player2->placeShips(true);
-		}
-		else {
-			if (_isAgainstComputer) {
-				cout << "Computer is placing ships..." << endl;
+			// Ship placement
+			if (_isComputerVsComputer) {
+				_player1->placeShips(true);
 				_player2->placeShips(true);
-				Sleep(1000);
 			}
+			else {
+				if (_isAgainstComputer) {
+					cout << "Computer is placing ships..." << endl;
+					_player2->placeShips(true);
+					cout << drainEvents() << endl;
+				}
 
-			bool autoPlace;
-			cout << "Player 1, auto-place ships? (1-yes, 0-no): ";
-			cin >> autoPlace;
-			_player1->placeShips(autoPlace);
+				_player1->placeShips(askYesNo("Player 1, auto-place ships?"));
 
-			if (!_isAgainstComputer) {
-				cout << "Player 2, auto-place ships? (1-yes, 0-no): ";
-				cin >> autoPlace;
-				_player2->placeShips(autoPlace);
+				if (!_isAgainstComputer && !_quit) {
+					_player2->placeShips(askYesNo("Player 2, auto-place ships?"));
+				}
+				if (_quit) {
+					typeText("\nExiting game. Goodbye!\n", 12);
+					return;
+				}
 			}
 		}
 
-		// Main game loop
-		Player* current = _player1;
-		Player* opponent = _player2;
+		// A resumed game has no shots before the save to record
+		GameRecord record;
+		if (!resumed) record.start(0, _seed, _player1->getBoard(), _player2->getBoard());
+
+		// Main game loop. Who is human is fixed by the mode, so no RTTI per turn.
+		Player* current = shooter == 0 ? _player1 : _player2;
+		Player* opponent = shooter == 0 ? _player2 : _player1;
+		const bool isHuman[2] = { computers[0] == nullptr, computers[1] == nullptr };
+
+		vector<Point> salvo;
 
 		while (true) {
 			displayDualBoards();
 
-			// Get attack
-			Point attack;
-			if (dynamic_cast<HumanPlayer*>(current)) {
-				attack = selectAttackWithCursor(current);
-				if (attack.getX() == -1) continue;
+			// The computer works out its reply while the human aims
+			int seat = current == _player1 ? 0 : 1;
+			ComputerPlayer* waiting = isHuman[seat] ? computers[1 - seat] : nullptr;
+			bool hit = false;
+
+			if (_salvo) {
+				int count = current->getBoard().getShipsAfloat();
+				if (isHuman[seat]) {
+					if (waiting) waiting->ponder();
+					salvo = selectSalvoWithCursor(current, count);
+					if (salvo.empty()) {
+						if (_quit) break;
+						continue;
+					}
+				}
+				else {
+					cout << "Computer thinking..." << flush;
+					current->selectAttacks(count, salvo);
+				}
+
+				// All shots land together; the turn passes regardless
+				AttackResult results[64];
+				opponent->getBoard().attackBatch(salvo, results);
+				for (size_t i = 0; i < salvo.size(); ++i) {
+					current->processAttackResult(salvo[i], results[i]);
+				}
 			}
 			else {
-				cout << "Computer thinking...";
-				Sleep(1500);
-				attack = current->selectAttack();
-			}
+				// Get attack
+				Point attack;
+				if (isHuman[seat]) {
+					if (waiting) waiting->ponder();
+					attack = selectAttackWithCursor(current);
+					if (attack.getX() == -1) {
+						if (_quit) break;
+						continue;
+					}
+				}
+				else {
+					cout << "Computer thinking..." << flush;
+					attack = current->selectAttack(); // Düşünmə vaxtı = çətinlik səviyyəsinin büdcəsi
+				}
 
-			// Process attack
-			bool hit = opponent->getBoard().attack(attack);
-			current->processAttackResult(attack, hit);
+				// Process attack
+				AttackResult result = opponent->getBoard().attack(attack);
+				current->processAttackResult(attack, result);
+				hit = result.isHit();
+				if (!resumed) record.addShot(attack, hit);
+			}
+			_status = drainEvents();
 
 			// Check win condition
 			if (opponent->getBoard().allShipsSunk()) {
+				Metrics::count(Counter::GamesPlayed);
+				record.finish(current == _player1 ? 0 : 1);
 				displayDualBoards();
 				string winner;
 				if (_isComputerVsComputer) {
@@ -342,12 +772,38 @@ public:
 				break;
 			}
 
+			// Computer vs Computer is paced by a frame timer; a key skips the wait
+			int key = _isComputerVsComputer ? Terminal::shared().readKey(COMPUTER_MOVE_MS) : Terminal::KEY_NONE;
+
 			// Switch turns if miss
 			if (!hit) swap(current, opponent);
+
+			// Computer vs Computer saves between moves
+			if (saveKey(key, current) && _quit) break;
+		}
+
+		// Saves are written in the background; wait for the last one
+		bool saved = true;
+		try {
+			_saver.finish();
+		}
+		catch (const exception& e) {
+			saved = false;
+			cout << "\nSave failed: " << e.what() << endl;
+		}
+		if (_quit) {
+			if (saved) typeText("\nGame saved to " + _savePath + ". Resume with --resume " + _savePath + "\n", 14);
+			return;
+		}
+
+		if (!_recordPath.empty() && !resumed) {
+			GameArchiveWriter archive(_recordPath);
+			BinaryWriter encoded, scratch;
+			GameArchiveWriter::encode(record, encoded, scratch);
+			archive.append(encoded);
+			cout << "Game saved to " << _recordPath << endl;
 		}
 
 		typeText("\nGame Over! Thanks for playing!\n", 14);
-		delete _player1;
-		delete _player2;
 	}
 };
\ No newline at end of file
@@ -1,134 +1,449 @@
 #pragma once
 
-class ComputerPlayer : public Player {
+enum class AIStrategy {
+	Hunt,       // Təsadüfi atəş, vurduqda qonşuları yoxla
+	Density,    // Ehtimal xəritəsi - ən çox yerləşmənin örtdüyü hüceyrə
+	MonteCarlo  // Vaxt limiti ilə təsadüfi donanma nümunələri
+};
+
+// Difficulty is the compute budget the Monte Carlo search gets per move
+enum class Difficulty {
+	Easy,
+	Normal,
+	Hard
+};
+
+class ComputerPlayer final : public Player {
 private:
-	map<int, int> _shipsLeft;
+	vector<int> _fleet;
+	FleetCounts _shipsLeft;
 	vector<Point> _targetQueue;
-	vector<vector<bool>> _attacked;
+	BitBoard _attacked;             // Atəş açılıb və ya boş olduğu bəllidir
+	AIStrategy _strategy;
+	DensityMap _density;
+	DensityMap _salvoDensity;       // selectAttacks() üçün qaralama
+	MonteCarloSearch _monteCarlo;
+	EndgameSolver _endgame;
+	bool _useEndgame;
+	FleetSampler _sampler;
+	vector<int> _placements;
+	chrono::microseconds _thinkBudget;
+	int _searchThreads;
+	const NeighbourTable* _neighbours;
+	bool _usePrior;                 // Standart donanma və lövhə - priorTable.h uyğundur
+	int _openingShot;
+	int _symmetry;
+	future<Point> _pondering;
+	atomic<bool> _stopPondering;
+	BinaryWriter _unpondered;       // ponder() başlamazdan əvvəlki saveKnowledge()
 
-	void addSurroundingPoints(const Point& p) {
-		static const int dx[] = { 0, 0, -1, 1 };
-		static const int dy[] = { -1, 1, 0, 0 };
+	// Next unfired cell of the generated opening, or -1 once it is used up.
+	// Each game turns the opening by one of the board's eight symmetries,
+	// so it is not the same shots every time.
+	int openingCell() {
+		if (!_usePrior) return -1;
+		if (_symmetry < 0) _symmetry = _rng.nextInt(8);
+
+		while (_openingShot < PRIOR_OPENING_LENGTH) {
+			int cell = PRIOR_OPENING[_openingShot++];
+			int x = cell % PRIOR_BOARD_SIZE, y = cell / PRIOR_BOARD_SIZE;
+			if (_symmetry & 1) x = PRIOR_BOARD_SIZE - 1 - x;
+			if (_symmetry & 2) y = PRIOR_BOARD_SIZE - 1 - y;
+			if (_symmetry & 4) swap(x, y);
+			if (!_attacked.test(y * PRIOR_BOARD_SIZE + x)) return y * PRIOR_BOARD_SIZE + x;
+		}
+		return -1;
+	}
+
+	Point markAttacked(int cell) {
+		int x = cell % board.getBoardSize();
+		int y = cell / board.getBoardSize();
+		_attacked.set(cell);
+		return Point(x, y);
+	}
+
+	// The attack board for the search models, and in afloat the lengths of
+	// the ships not sunk yet, longest first. A line of hits closed off at
+	// both ends is a whole ship, so it has been sunk: its cells go in as
+	// empty and its length comes off the fleet the models still look for.
+	vector<char> knowledge(vector<int>& afloat) const {
+		int size = board.getBoardSize();
+		vector<char> known(size * size, CELL_UNKNOWN);
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				char cell = _attackBoard[y][x];
+				if (cell == 'H') known[y * size + x] = CELL_HIT;
+				else if (cell == 'M' || cell == '.') known[y * size + x] = CELL_EMPTY;
+			}
+		}
+
+		afloat = _fleet;
+		sort(afloat.begin(), afloat.end(), greater<int>());
+		auto closed = [&](int x, int y) {
+			return x < 0 || y < 0 || x >= size || y >= size || _attackBoard[y][x] == 'M' || _attackBoard[y][x] == '.';
+		};
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				if (_attackBoard[y][x] != 'H') continue;
+				// Xəttin başlanğıcı: solda və yuxarıda vuruş yoxdur
+				if ((x > 0 && _attackBoard[y][x - 1] == 'H') || (y > 0 && _attackBoard[y - 1][x] == 'H')) continue;
 
-		for (size_t dir = 0; dir < 4; ++dir) {
-			int nx = p.getX() + dx[dir];
-			int ny = p.getY() + dy[dir];
+				int across = 1, down = 1;
+				while (x + across < size && _attackBoard[y][x + across] == 'H') ++across;
+				while (y + down < size && _attackBoard[y + down][x] == 'H') ++down;
+				bool sunk = closed(x - 1, y) && closed(x + across, y) && closed(x, y - 1) && closed(x, y + down);
+				if (across > 1) sunk = closed(x - 1, y) && closed(x + across, y);
+				if (down > 1) sunk = closed(x, y - 1) && closed(x, y + down);
+				if (!sunk) continue;
 
-			if (nx >= 0 && nx < board.getBoardSize() && ny >= 0 && ny < board.getBoardSize()) {
-				if (!_attacked[ny][nx]) {
-					_targetQueue.push_back(Point(nx, ny));
+				int length = max(across, down);
+				for (int i = 0; i < length; ++i) {
+					known[(y + (down > 1 ? i : 0)) * size + x + (across > 1 ? i : 0)] = CELL_EMPTY;
 				}
+				auto ship = find(afloat.begin(), afloat.end(), length);
+				if (ship != afloat.end()) afloat.erase(ship);
 			}
 		}
+		return known;
+	}
+
+	void addSurroundingPoints(const Point& p) {
+		int size = board.getBoardSize();
+		const short* neighbours = _neighbours->orthogonal(p.getY() * size + p.getX());
+
+		for (int dir = 0; dir < 4; ++dir) {
+			int cell = neighbours[dir];
+			if (cell >= 0 && !_attacked.test(cell)) {
+				_targetQueue.push_back(Point(cell % size, cell / size));
+			}
+		}
+	}
+
+	// Halo of a sunk ship: never worth a shot, and known empty for the density map
+	void excludeCell(int x, int y) override {
+		Player::excludeCell(x, y);
+		_attacked.set(y * board.getBoardSize() + x);
+		if (_strategy != AIStrategy::Hunt && !_density.isKnown(x, y)) _density.applyMiss(x, y);
 	}
 
 	int getRandomShipLength() {
 		vector<int> availableLengths;
-		for (auto& ship : _shipsLeft) {
-			if (ship.second > 0) {
-				availableLengths.push_back(ship.first);
+		for (int length = 1; length <= _shipsLeft.getLongest(); ++length) {
+			if (_shipsLeft[length] > 0) {
+				availableLengths.push_back(length);
 			}
 		}
 
 		if (availableLengths.empty()) return -1;
 
-		int index = rand() % availableLengths.size();
+		int index = _rng.nextInt(static_cast<int>(availableLengths.size()));
 		return availableLengths[index];
 	}
 
-	bool tryPlaceShip(int length) {
-		const int maxAttempt = 50;
-		int attempts = 0;
+	void saveKnowledge(BinaryWriter& out) const override {
+		Player::saveKnowledge(out);
+		int size = board.getBoardSize();
+		out.writeVarint(_targetQueue.size());
+		for (const Point& p : _targetQueue) {
+			out.writeVarint(static_cast<uint64_t>(p.getY() * size + p.getX()));
+		}
 
-		while (attempts < maxAttempt)
-		{
-			int x = rand() % board.getBoardSize();
-			int y = rand() % board.getBoardSize();
-			bool horizontal = rand() % 2;
+		uint8_t bits = 0;
+		for (int c = 0; c < size * size; ++c) {
+			if (_attacked.test(c)) bits |= static_cast<uint8_t>(1 << (c & 7));
+			if ((c & 7) == 7 || c == size * size - 1) {
+				out.writeU8(bits);
+				bits = 0;
+			}
+		}
 
-			Ship ship(Point(x, y), horizontal, length);
+		for (int length = 1; length <= _shipsLeft.getLongest(); ++length) {
+			if (_shipsLeft.inFleet(length) > 0) out.writeVarint(static_cast<uint64_t>(max(_shipsLeft[length], 0)));
+		}
+		out.writeU8(static_cast<uint8_t>(_openingShot));
+		out.writeU8(static_cast<uint8_t>(_symmetry + 1));
+	}
 
-			if (board.canPlaceShip(ship)) {
-				board.placeShip(ship);
-				_shipsLeft[length]--;
-				return true;
+	void loadKnowledge(BinaryReader& in) override {
+		Player::loadKnowledge(in);
+		int size = board.getBoardSize();
+		uint64_t queued = in.readVarint();
+		if (queued > static_cast<uint64_t>(4 * size * size)) throw runtime_error("Corrupt computer player state");
+		_targetQueue.clear();
+		for (uint64_t i = 0; i < queued; ++i) {
+			uint64_t cell = in.readVarint();
+			if (cell >= static_cast<uint64_t>(size * size)) throw runtime_error("Corrupt computer player state");
+			_targetQueue.push_back(Point(static_cast<int>(cell % size), static_cast<int>(cell / size)));
+		}
+
+		uint8_t bits = 0;
+		for (int c = 0; c < size * size; ++c) {
+			if ((c & 7) == 0) bits = in.readU8();
+			if ((bits >> (c & 7)) & 1) _attacked.set(c);
+			else _attacked.reset(c);
+		}
+
+		for (int length = 1; length <= _shipsLeft.getLongest(); ++length) {
+			if (_shipsLeft.inFleet(length) == 0) continue;
+			uint64_t left = in.readVarint();
+			if (left > static_cast<uint64_t>(_shipsLeft.inFleet(length))) throw runtime_error("Corrupt computer player state");
+			_shipsLeft[length] = static_cast<int>(left);
+		}
+		_openingShot = in.readU8();
+		_symmetry = static_cast<int>(in.readU8()) - 1;
+
+		// The density map is not saved: it follows from the attack board.
+		// Hits go first so their diagonals are known before the misses and halos,
+		// which ends in the same state as the shots in their real order. The
+		// ships sunk so far are the ones knowledge() finds.
+		_density.reset();
+		if (_strategy == AIStrategy::Hunt) return;
+		for (char mark : { 'H', 'M', '.' }) {
+			for (int y = 0; y < size; ++y) {
+				for (int x = 0; x < size; ++x) {
+					if (_attackBoard[y][x] != mark || _density.isKnown(x, y)) continue;
+					if (mark == 'H') _density.applyHit(x, y);
+					else _density.applyMiss(x, y);
+				}
 			}
-			attempts++;
 		}
-		return false;
+
+		vector<int> afloat;
+		knowledge(afloat);
+		FleetCounts sunk(_fleet);
+		for (int length : afloat) sunk[length]--;
+		for (int length = 1; length <= sunk.getLongest(); ++length) {
+			for (int i = 0; i < sunk[length]; ++i) _density.removeShip(length);
+		}
+	}
+
+	// The shot selectAttack() returns, worked out now; may run on a pondering thread
+	Point think() {
+		Metrics::Timer timer(Histogram::AiThink);
+		chrono::microseconds budget = _thinkBudget;
+		if (_useEndgame) {
+			// Half the budget at most; the rest is left for sampling if it gives up
+			auto started = chrono::steady_clock::now();
+			vector<int> afloat;
+			vector<char> known = knowledge(afloat);
+			int cell = _endgame.solve(known, afloat, _thinkBudget / 2, _searchThreads, &_stopPondering);
+			if (cell >= 0) return markAttacked(cell);
+			budget -= chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - started);
+		}
+
+		if (_strategy == AIStrategy::MonteCarlo) {
+			vector<int> afloat;
+			vector<char> known = knowledge(afloat);
+			int cell = _monteCarlo.search(known, afloat, max(budget, chrono::microseconds(0)), _searchThreads, _rng.next(), &_stopPondering);
+			if (cell < 0) cell = _density.bestCell(_rng);
+			if (cell >= 0) return markAttacked(cell);
+		}
+
+		if (_strategy == AIStrategy::Density) {
+			int cell = _density.bestCell(_rng);
+			if (cell >= 0) return markAttacked(cell);
+		}
+
+		while (!_targetQueue.empty()) {
+			Point target = _targetQueue.back();
+			_targetQueue.pop_back();
+			int cell = target.getY() * board.getBoardSize() + target.getX();
+			if (_attacked.test(cell)) continue; // İki vuruşun qonşusu və ya artıq boş olduğu bəllidir
+			_attacked.set(cell);
+			return target;
+		}
+
+		// Nothing to chase: the generated opening first, then random shots
+		int cell = openingCell();
+		if (cell >= 0) return markAttacked(cell);
+
+		int x, y;
+		do {
+			x = _rng.nextInt(board.getBoardSize());
+			y = _rng.nextInt(board.getBoardSize());
+		} while (_attacked.test(y * board.getBoardSize() + x));
+
+		return markAttacked(y * board.getBoardSize() + x);
 	}
 
 public:
-	ComputerPlayer(Board& board) : Player(board) {
-		_shipsLeft[4] = 1;
-		_shipsLeft[3] = 2;
-		_shipsLeft[2] = 3;
-		_shipsLeft[1] = 4;
+	ComputerPlayer(Board& board, AIStrategy strategy = AIStrategy::Hunt, Rng rng = Rng(),
+		const vector<int>& fleet = StandardFleet::lengths())
+		: Player(board, rng), _fleet(fleet), _shipsLeft(fleet),
+		_attacked(board.getBoardSize() * board.getBoardSize()), _strategy(strategy),
+		_density(board.getBoardSize(), fleet),
+		_salvoDensity(_density),
+		_monteCarlo(board.getBoardSize(), fleet),
+		_endgame(board.getBoardSize(), fleet),
+		_useEndgame(strategy == AIStrategy::MonteCarlo),
+		_sampler(board.getBoardSize(), fleet),
+		_thinkBudget(thinkBudget(Difficulty::Normal)),
+		_searchThreads(max(1u, thread::hardware_concurrency())),
+		_neighbours(&NeighbourTable::get(board.getBoardSize())),
+		_usePrior(board.getBoardSize() == PRIOR_BOARD_SIZE && fleet == StandardFleet::lengths()),
+		_openingShot(0), _symmetry(-1), _stopPondering(false) {
+	}
 
-		_attacked.resize(board.getBoardSize(), vector<bool>(board.getBoardSize(), false));
+	~ComputerPlayer() override {
+		stopPondering();
 	}
 
 	void reset() override {
-		board.reset();
-		_shipsLeft.clear();
-		_shipsLeft[4] = 1;
-		_shipsLeft[3] = 2;
-		_shipsLeft[2] = 3;
-		_shipsLeft[1] = 4;
+		stopPondering();
+		Player::reset();
+		_shipsLeft.reset();
 		_targetQueue.clear();
-		_attacked = vector<vector<bool>>(board.getBoardSize(), vector<bool>(board.getBoardSize(), false));
-
+		_attacked.clear();
+		_density.reset();
+		_openingShot = 0;
+		_symmetry = -1;
 	}
 
 	void placeShips(bool autoPlace = false) override {
+		if (!_sampler.placeFleet(board, _rng, _placements)) {
+			EventRing::emit(_events, GameEventType::PlacementFailed, _seat);
+			throw runtime_error("Could not place the fleet");
+		}
+		for (int p : _placements) {
+			_shipsLeft[_sampler.getTable().getLength(p)]--;
+		}
+		EventRing::emit(_events, GameEventType::FleetPlaced, _seat);
+	}
 
-		cout << "Computer is placing ships..." << endl;
-
-		vector<int> shipLengths = { 4,3,3,2,2,2,1,1,1,1 };
+	void takeTurn() override {
+		Point attackPoint = selectAttack();
+		if (board.attack(attackPoint).isHit()) {
+			addSurroundingPoints(attackPoint);
+		}
+	}
 
-		for (int length : shipLengths) {
-			if (_shipsLeft[length] <= 0)continue;
+	AIStrategy getStrategy() const {
+		return _strategy;
+	}
 
-			if (!tryPlaceShip(length)) {
-				cout << "Warning: Could not place ship of length " << length << endl;
-			}
+	static chrono::microseconds thinkBudget(Difficulty difficulty) {
+		switch (difficulty) {
+		case Difficulty::Easy: return chrono::microseconds(200);
+		case Difficulty::Hard: return chrono::milliseconds(1500);
+		default: return chrono::milliseconds(50);
 		}
+	}
 
-		cout << "Computer's ships placed!" << endl;
+	void setDifficulty(Difficulty difficulty) {
+		_thinkBudget = thinkBudget(difficulty);
 	}
 
-	void takeTurn() override {
-		Point attackPoint = selectAttack();
+	void setThinkBudget(chrono::microseconds budget) {
+		_thinkBudget = budget;
+	}
 
-		if (board.attack(attackPoint)) {
-			cout << "Computer hit at ( " << attackPoint.getX() << ", " << attackPoint.getY() << " )" << endl;
-			addSurroundingPoints(attackPoint);
-		}
-		else {
-			cout << "Computer missed at ( " << attackPoint.getX() << ". " << attackPoint.getY() << " )" << endl;
+	// 1 keeps the search on the calling thread (batch runs are already parallel)
+	void setSearchThreads(int threads) {
+		_searchThreads = max(1, threads);
+	}
+
+	// Exact search once few fleet layouts are left. On by default for
+	// MonteCarlo, which spends its think budget on every move anyway.
+	void setEndgameSolver(bool enabled) {
+		_useEndgame = enabled;
+	}
+
+	// Starts working out the next shot on another thread, e.g. while the
+	// opponent picks theirs; selectAttack() then only collects it. Nothing
+	// this player knows changes before its own shots land, so the answer
+	// holds however the opponent's turn goes. Until selectAttack(), the
+	// caller must not touch this player except to read its boards.
+	void ponder() {
+		if (_pondering.valid()) return;
+		_unpondered.clear();
+		saveKnowledge(_unpondered);
+		_stopPondering.store(false);
+		_pondering = async(launch::async, [this] { return think(); });
+	}
+
+	bool isPondering() const {
+		return _pondering.valid();
+	}
+
+	// Cuts a ponder short and drops its shot; for when it will never be asked for
+	void stopPondering() {
+		if (!_pondering.valid()) return;
+		_stopPondering.store(true);
+		_pondering.get();
+		_stopPondering.store(false);
+	}
+
+	// The pondering thread changes this player's knowledge as it goes, so a
+	// save taken meanwhile uses the copy ponder() made before it started.
+	// Nothing the game has seen differs between the two.
+	void saveState(BinaryWriter& out) const override {
+		if (!_pondering.valid()) {
+			Player::saveState(out);
+			return;
 		}
+		board.write(out);
+		out.writeBytes(_unpondered.data().data(), _unpondered.size());
+	}
+
+	void loadState(BinaryReader& in) override {
+		stopPondering();
+		Player::loadState(in);
 	}
 
 	Point selectAttack() override {
-		if (!_targetQueue.empty()) {
-			Point target = _targetQueue.back();
-			_targetQueue.pop_back();
-			_attacked[target.getY()][target.getX()] = true;
-			return target;
-		}
+		if (_pondering.valid()) return _pondering.get();
+		return think();
+	}
 
-		int x, y;
-		do {
-			x = rand() % board.getBoardSize();
-			y = rand() % board.getBoardSize();
-		} while (_attacked[y][x]);
+	// The first shot is the one selectAttack() would fire. Each further shot
+	// is the best cell given that the shots before it missed, so a salvo
+	// spreads over the places the fleet could still be instead of piling
+	// onto one likely spot. Hunt just keeps going down its own order.
+	void selectAttacks(int count, vector<Point>& shots) override {
+		shots.clear();
+		if (count <= 0) return;
+		shots.push_back(selectAttack()); // Collects a ponder, so _attacked is only read after it
 
-		_attacked[y][x] = true;
-		return Point(x, y);
+		// Sonda atəş açılmamış hüceyrə gəmidən az ola bilər
+		int open = _attacked.getBitCount() - _attacked.count();
+		count = min(count, open + 1);
+
+		if (_strategy == AIStrategy::Hunt) {
+			while (static_cast<int>(shots.size()) < count) shots.push_back(think());
+			return;
+		}
+
+		_salvoDensity.copyState(_density);
+		while (static_cast<int>(shots.size()) < count) {
+			const Point& last = shots.back();
+			if (!_salvoDensity.isKnown(last.getX(), last.getY())) {
+				_salvoDensity.applyMiss(last.getX(), last.getY());
+			}
+			int cell = _salvoDensity.bestCell(_rng);
+			if (cell < 0) break; // Atəş açılası yer qalmayıb
+			shots.push_back(markAttacked(cell));
+		}
 	}
 
-	void processAttackResult(const Point& p, bool hit) override {
-		if (hit) {
+	// A sunk ship's halo comes off the attack board, the density map and
+	// the target queue, so no shot is spent on the cells around it, and its
+	// length comes off the fleet the density map still counts
+	void processAttackResult(const Point& p, const AttackResult& result) override {
+		if (result.outcome == AttackOutcome::Rejected || !board.isValid(p)) return;
+		bool hit = result.isHit();
+
+		if (_strategy != AIStrategy::Hunt && !_density.isKnown(p.getX(), p.getY())) {
+			if (hit) _density.applyHit(p.getX(), p.getY());
+			else _density.applyMiss(p.getX(), p.getY());
+		}
+
+		Player::processAttackResult(p, result);
+
+		if (result.isSunk()) {
+			if (_strategy != AIStrategy::Hunt) _density.removeShip(result.length);
+			erase_if(_targetQueue, [this](const Point& target) { return _attacked.test(target.getY() * board.getBoardSize() + target.getX()); });
+		}
+		else if (hit) {
 			addSurroundingPoints(p);
 		}
 	}
@@ -1,12 +1,16 @@
 #pragma once
 
-#define KEY_UP 72
-#define KEY_DOWN 80
-#define KEY_RIGHT 77
-#define KEY_LEFT 75
+// Arrow keys as decoded by Terminal::readKey - outside the character range
+// so they no longer collide with letters ('H' used to read as KEY_UP)
+#define KEY_UP 1000
+#define KEY_DOWN 1001
+#define KEY_RIGHT 1002
+#define KEY_LEFT 1003
+#define KEY_EOF 1004     // stdin bağlanıb - daha düymə gəlməyəcək
 #define ESC 27
 #define ENTER_KEY 13
 #define ROTATE 32 
+#define COMPUTER_MOVE_MS 250 // Computer vs Computer frame pacing
 
 #define COLOR_RESET "\033[0m"
 #define COLOR_MAGENTA "\033[35m"
@@ -0,0 +1,216 @@
+#pragma once
+
+
+// Probability density for targeting: for every cell, the weighted number of
+// legal placements of the opponent's fleet that cover it. Placements through
+// a known miss are dropped; placements through hits are weighted up so the
+// AI finishes wounded ships first, and a sunk ship's length counts one copy
+// fewer from then on. Every shot only touches the placements
+// that cover the shot cell, so the map is never recounted during a game.
+// That update is a scalar scatter and is not vectorized: a dense recount of
+// the 10x10 map per ship length, which does vectorize, took about 5 us per
+// shot against about 0.35 us for the scatter. Nothing here uses SIMD
+// intrinsics. bestCell() only leaves its passes branch-free for the
+// compiler's auto-vectorizer, and GCC 12 at the Makefile's -O2 keeps them
+// scalar; -O3 vectorizes the tie count.
+class DensityMap {
+private:
+	static const int HIT_WEIGHT = 12; // Hər vurulmuş hüceyrə üçün çəki vuruğu
+
+	int _size;
+	int _cellCount;
+	const NeighbourTable* _neighbours;
+
+	// Placements, struct-of-arrays
+	vector<int> _placementFirst;   // _placementCells-də ilk hüceyrənin yeri
+	vector<int> _placementLength;
+	vector<int> _placementCells;
+	vector<int> _placementFleet;   // Bu uzunluqda neçə gəmi var
+	vector<int> _lengthFirst;      // Uzunluq -> ilk yerləşmə; yerləşmələr uzunluğa görə sıralanıb
+
+	// Cell -> placements covering it (CSR)
+	vector<int> _cellFirst;
+	vector<int> _cellPlacements;
+
+	// Per-game state
+	vector<int> _blocked;          // Yerləşmənin örtdüyü boş (miss) hüceyrələr
+	vector<int> _hits;             // Yerləşmənin örtdüyü vurulmuş hüceyrələr
+	vector<int> _counts;
+	vector<int> _baseCounts;       // Boş lövhə üçün hesablanmış sayğaclar
+	vector<int> _known;            // 1 - hüceyrəyə atəş açılıb və ya boş olduğu bəllidir
+	vector<int> _copies;           // Yerləşmənin uzunluğunda batırılmamış gəmi sayı
+	vector<int> _scratch;
+
+	// One ship's share of the placement's weight
+	int hitFactor(int p) const {
+		int w = 1;
+		for (int h = 0; h < _hits[p]; ++h) w *= HIT_WEIGHT;
+		return w;
+	}
+
+	int weight(int p) const {
+		if (_blocked[p] > 0) return 0;
+		return _copies[p] * hitFactor(p);
+	}
+
+	// Scalar scatter into the placement's cells - a few adds per placement
+	void addToCells(int p, int delta) {
+		const int* cells = &_placementCells[_placementFirst[p]];
+		int length = _placementLength[p];
+		for (int i = 0; i < length; ++i) {
+			_counts[cells[i]] += delta;
+		}
+	}
+
+	void addPlacement(int x, int y, int length, bool horizontal, int copies) {
+		_placementFirst.push_back(static_cast<int>(_placementCells.size()));
+		_placementLength.push_back(length);
+		_placementFleet.push_back(copies);
+		for (int i = 0; i < length; ++i) {
+			int cx = x + (horizontal ? i : 0);
+			int cy = y + (horizontal ? 0 : i);
+			_placementCells.push_back(cy * _size + cx);
+		}
+	}
+
+	void build(const vector<int>& shipLengths) {
+		map<int, int> copies;
+		for (int length : shipLengths) copies[length]++;
+		int longest = copies.empty() ? 0 : copies.rbegin()->first;
+		_lengthFirst.assign(longest + 2, 0);
+
+		for (auto& entry : copies) {
+			int length = entry.first;
+			_lengthFirst[length] = static_cast<int>(_placementLength.size());
+			forEachPlacement(_size, length, [&](int x, int y, bool horizontal) {
+				addPlacement(x, y, length, horizontal, entry.second);
+			});
+		}
+		_lengthFirst[longest + 1] = static_cast<int>(_placementLength.size());
+		for (int length = longest; length > 0; --length) {
+			if (copies.count(length) == 0) _lengthFirst[length] = _lengthFirst[length + 1];
+		}
+		_copies = _placementFleet;
+
+		int placements = static_cast<int>(_placementLength.size());
+		vector<int> perCell(_cellCount, 0);
+		for (int cell : _placementCells) perCell[cell]++;
+
+		_cellFirst.assign(_cellCount + 1, 0);
+		for (int c = 0; c < _cellCount; ++c) _cellFirst[c + 1] = _cellFirst[c] + perCell[c];
+
+		_cellPlacements.assign(_placementCells.size(), 0);
+		vector<int> cursor = _cellFirst;
+		for (int p = 0; p < placements; ++p) {
+			for (int i = 0; i < _placementLength[p]; ++i) {
+				int cell = _placementCells[_placementFirst[p] + i];
+				_cellPlacements[cursor[cell]++] = p;
+			}
+		}
+
+		_blocked.assign(placements, 0);
+		_hits.assign(placements, 0);
+		_counts.assign(_cellCount, 0);
+		for (int p = 0; p < placements; ++p) addToCells(p, weight(p));
+		_baseCounts = _counts;
+		_known.assign(_cellCount, 0);
+		_scratch.assign(_cellCount, 0);
+	}
+
+public:
+	DensityMap(int size, const vector<int>& shipLengths)
+		: _size(size), _cellCount(size * size), _neighbours(&NeighbourTable::get(size)) {
+		build(shipLengths);
+	}
+
+	void reset() {
+		copy(_baseCounts.begin(), _baseCounts.end(), _counts.begin());
+		fill(_blocked.begin(), _blocked.end(), 0);
+		fill(_hits.begin(), _hits.end(), 0);
+		fill(_known.begin(), _known.end(), 0);
+		copy(_placementFleet.begin(), _placementFleet.end(), _copies.begin());
+	}
+
+	// Takes over another map's game so far; both must be built for the same board and fleet
+	void copyState(const DensityMap& other) {
+		copy(other._blocked.begin(), other._blocked.end(), _blocked.begin());
+		copy(other._hits.begin(), other._hits.end(), _hits.begin());
+		copy(other._counts.begin(), other._counts.end(), _counts.begin());
+		copy(other._known.begin(), other._known.end(), _known.begin());
+		copy(other._copies.begin(), other._copies.end(), _copies.begin());
+	}
+
+	int getCount(int x, int y) const { return _counts[y * _size + x]; }
+	bool isKnown(int x, int y) const { return _known[y * _size + x] != 0; }
+
+	// Cell is known to be empty: a miss, or ruled out by the no-touch rule
+	void applyMiss(int x, int y) {
+		int cell = y * _size + x;
+		_known[cell] = 1;
+		for (int i = _cellFirst[cell]; i < _cellFirst[cell + 1]; ++i) {
+			int p = _cellPlacements[i];
+			if (_blocked[p] == 0) {
+				addToCells(p, -weight(p));
+			}
+			_blocked[p]++;
+		}
+	}
+
+	void applyHit(int x, int y) {
+		int cell = y * _size + x;
+		_known[cell] = 1;
+		for (int i = _cellFirst[cell]; i < _cellFirst[cell + 1]; ++i) {
+			int p = _cellPlacements[i];
+			if (_blocked[p] > 0) {
+				_hits[p]++;
+				continue;
+			}
+			int before = weight(p);
+			_hits[p]++;
+			addToCells(p, weight(p) - before);
+		}
+
+		// Gəmilər diaqonal toxuna bilməz - diaqonal qonşular boşdur
+		const short* diagonal = _neighbours->diagonal(cell);
+		for (int d = 0; d < 4; ++d) {
+			int n = diagonal[d];
+			if (n >= 0 && !_known[n]) {
+				applyMiss(n % _size, n / _size);
+			}
+		}
+	}
+
+	// A ship of this length was sunk: one copy fewer of each of its placements
+	void removeShip(int length) {
+		if (length < 1 || length + 1 >= static_cast<int>(_lengthFirst.size())) return;
+		for (int p = _lengthFirst[length]; p < _lengthFirst[length + 1]; ++p) {
+			if (_copies[p] == 0) return;
+			if (_blocked[p] == 0) addToCells(p, -hitFactor(p));
+			_copies[p]--;
+		}
+	}
+
+	// Highest-density cell not yet known; ties are broken at random.
+	// Returns -1 when every cell is known.
+	int bestCell(Rng& rng) {
+		// Branch-free passes over flat int arrays; no intrinsics, see the class comment
+		int best = -1;
+		for (int c = 0; c < _cellCount; ++c) {
+			int value = _known[c] ? -1 : _counts[c];
+			_scratch[c] = value;
+			best = value > best ? value : best;
+		}
+		if (best < 0) return -1;
+
+		int ties = 0;
+		for (int c = 0; c < _cellCount; ++c) {
+			ties += (_scratch[c] == best);
+		}
+
+		int pick = rng.nextInt(ties);
+		for (int c = 0; c < _cellCount; ++c) {
+			if (_scratch[c] == best && pick-- == 0) return c;
+		}
+		return -1;
+	}
+};
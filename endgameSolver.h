@@ -0,0 +1,334 @@
+#pragma once
+
+
+// Exact late-game shot selection. When the fleet layouts consistent with
+// the attack board are few enough to list, they are enumerated with the
+// PlacementTable bitmasks, and an expectimax over "which layout is the real
+// one" finds the shot with the fewest expected shots left to finish. A set
+// of layouts is itself a bitmask, which makes it a cheap memo key.
+//
+// Every ship cell has to be hit whatever the order, so fewest shots is the
+// same as fewest misses, and that is what the search counts. Layouts are
+// weighted equally. A cell every layout has a ship on is a sure hit and is
+// fired at straight away; only cells the layouts disagree on are searched.
+// Only ships still afloat are enumerated; a sunk ship's cells come in as
+// CELL_EMPTY.
+class EndgameSolver {
+public:
+	static const int MAX_LAYOUTS = 256;
+
+private:
+	static const int SET_WORDS = MAX_LAYOUTS / 64;
+	static const long long MAX_STEPS = 200000;  // Sadalama addımları - bundan çoxdursa, oyun sonu deyil
+	static const int DEADLINE_CHECK = 256;      // Hər bu qədər düyündə vaxt yoxlanır
+
+	struct LayoutSet {
+		uint64_t bits[SET_WORDS];
+
+		bool operator==(const LayoutSet& other) const {
+			for (int w = 0; w < SET_WORDS; ++w) {
+				if (bits[w] != other.bits[w]) return false;
+			}
+			return true;
+		}
+
+		int size() const {
+			int n = 0;
+			for (int w = 0; w < SET_WORDS; ++w) n += popCount(bits[w]);
+			return n;
+		}
+	};
+
+	struct LayoutSetHash {
+		size_t operator()(const LayoutSet& set) const {
+			uint64_t h = 0;
+			for (int w = 0; w < SET_WORDS; ++w) h = (h ^ set.bits[w]) * 0x9E3779B97F4A7C15ULL;
+			return static_cast<size_t>(h ^ (h >> 29));
+		}
+	};
+
+	// Consistent layouts, and for every disputed cell the layouts with a ship on it
+	struct Problem {
+		int layoutCount = 0;
+		vector<uint64_t> layouts;       // Hər layout üçün maskWords söz
+		vector<int> cells;
+		vector<LayoutSet> withShip;
+		LayoutSet all = {};
+	};
+
+	// A shot at problem.cells[cell] and the layouts it leaves on a hit and a miss
+	struct Shot {
+		double missChance;
+		int cell;
+		int hits;
+		LayoutSet hit, miss;
+
+		bool operator<(const Shot& other) const {
+			return missChance < other.missChance || (missChance == other.missChance && cell < other.cell);
+		}
+	};
+
+	// One expectimax search, run by a single thread
+	struct Search {
+		const Problem& problem;
+		chrono::steady_clock::time_point deadline;
+		const atomic<bool>& cancelled;
+		const atomic<bool>* stop;
+		unordered_map<LayoutSet, double, LayoutSetHash> memo;
+		vector<vector<Shot>> shots;     // Dərinlik üzrə, təkrar istifadə olunur
+		long long nodes = 0;
+		bool timedOut = false;
+
+		Search(const Problem& p, chrono::steady_clock::time_point d, const atomic<bool>& c, const atomic<bool>* s)
+			: problem(p), deadline(d), cancelled(c), stop(s) {
+			// Every shot splits off at least one layout, so the depth stays below that
+			shots.resize(MAX_LAYOUTS + 1);
+		}
+
+		// Shots that tell set's layouts apart, likeliest hit first
+		vector<Shot>& rank(const LayoutSet& set, int total, size_t depth) {
+			vector<Shot>& ranked = shots[depth];
+			ranked.clear();
+			Shot shot;
+			for (size_t i = 0; i < problem.cells.size(); ++i) {
+				for (int w = 0; w < SET_WORDS; ++w) {
+					shot.hit.bits[w] = set.bits[w] & problem.withShip[i].bits[w];
+					shot.miss.bits[w] = set.bits[w] & ~problem.withShip[i].bits[w];
+				}
+				shot.hits = shot.hit.size();
+				if (shot.hits == 0 || shot.hits == total) continue;
+
+				shot.cell = static_cast<int>(i);
+				shot.missChance = (total - shot.hits) / static_cast<double>(total);
+				ranked.push_back(shot);
+			}
+			sort(ranked.begin(), ranked.end());
+			return ranked;
+		}
+
+		// Expected misses from this shot on
+		double value(const Shot& shot, int total, size_t depth) {
+			int misses = total - shot.hits;
+			return (shot.hits * solve(shot.hit, depth + 1) + misses * (1 + solve(shot.miss, depth + 1))) / static_cast<double>(total);
+		}
+
+		double solve(const LayoutSet& set, size_t depth) {
+			int total = set.size();
+			if (total <= 1 || timedOut) return 0;
+
+			auto found = memo.find(set);
+			if (found != memo.end()) return found->second;
+
+			if (++nodes % DEADLINE_CHECK == 0 &&
+				(cancelled.load(memory_order_relaxed) || (stop && stop->load(memory_order_relaxed)) ||
+					chrono::steady_clock::now() >= deadline)) {
+				timedOut = true;
+				return 0;
+			}
+
+			// Branch and bound: a shot expects at least its own miss, so once
+			// that reaches the best so far, so does every shot after it
+			double best = numeric_limits<double>::max();
+			vector<Shot>& ranked = rank(set, total, depth);
+			for (size_t k = 0; k < ranked.size() && ranked[k].missChance < best; ++k) {
+				best = min(best, value(ranked[k], total, depth));
+				if (timedOut) return 0;
+			}
+			memo[set] = best;
+			return best;
+		}
+	};
+
+	int _size;
+	int _cellCount;
+	int _maskWords;
+	int _longest;
+	shared_ptr<const PlacementTable> _table;
+
+	// Depth-first over placements: first cover every hit, then place the
+	// ships left on free cells. Ships of one length go in increasing
+	// placement order, so each layout comes out once.
+	struct Enumeration {
+		const EndgameSolver& solver;
+		const vector<int>& lengths;     // Azalan sırada
+		vector<int> hitCells;
+		vector<int> left;               // Uzunluq -> yerləşdirilməmiş gəmi sayı
+		vector<BitBoard> blocked;       // Dərinlik üzrə
+		vector<BitBoard> covered;
+		vector<uint64_t>& layouts;
+		int count = 0;
+		long long steps = 0;
+		bool tooMany = false;
+
+		Enumeration(const EndgameSolver& s, const vector<int>& l, vector<uint64_t>& out) : solver(s), lengths(l), layouts(out) {
+		}
+
+		void place(int depth, int p) {
+			blocked[depth + 1] = blocked[depth];
+			covered[depth + 1] = covered[depth];
+			solver._table->occupy(p, blocked[depth + 1]);
+			const uint64_t* mask = solver._table->cellMask(p);
+			uint64_t* words = covered[depth + 1].words();
+			for (int w = 0; w < solver._maskWords; ++w) words[w] |= mask[w];
+			left[solver._table->getLength(p)]--;
+		}
+
+		// A hit no ship covers but that a halo has closed can never be covered
+		bool hitsReachable(int depth) const {
+			for (int hit : hitCells) {
+				if (!covered[depth].test(hit) && blocked[depth].test(hit)) return false;
+			}
+			return true;
+		}
+
+		void run(int depth, size_t nextShip, int lastPlacement) {
+			if (tooMany || ++steps > MAX_STEPS) {
+				tooMany = true;
+				return;
+			}
+
+			int uncovered = -1;
+			for (int hit : hitCells) {
+				if (!covered[depth].test(hit)) {
+					uncovered = hit;
+					break;
+				}
+			}
+
+			if (uncovered >= 0) {
+				for (int p : solver._table->covering(uncovered)) {
+					int length = solver._table->getLength(p);
+					if (left[length] == 0 || !solver._table->isFree(p, blocked[depth])) continue;
+					place(depth, p);
+					if (hitsReachable(depth + 1)) run(depth + 1, 0, -1);
+					left[length]++;
+					if (tooMany) return;
+				}
+				return;
+			}
+
+			// Hər vuruş örtülüb - qalan gəmilər uzunluğa görə
+			while (nextShip < lengths.size() && left[lengths[nextShip]] == 0) ++nextShip;
+			if (nextShip == lengths.size()) {
+				if (++count > MAX_LAYOUTS) {
+					tooMany = true;
+					return;
+				}
+				const uint64_t* words = covered[depth].words();
+				layouts.insert(layouts.end(), words, words + solver._maskWords);
+				return;
+			}
+
+			int length = lengths[nextShip];
+			int after = lastPlacement >= 0 && solver._table->getLength(lastPlacement) == length ? lastPlacement : -1;
+			for (int p : solver._table->withLength(length)) {
+				if (p <= after) continue;
+				if (!solver._table->isFree(p, blocked[depth])) continue;
+				place(depth, p);
+				run(depth + 1, nextShip, p);
+				left[length]++;
+				if (tooMany) return;
+			}
+		}
+	};
+
+	bool enumerate(const vector<char>& known, const vector<int>& lengths, Problem& problem) const {
+		Enumeration e(*this, lengths, problem.layouts);
+		e.left.assign(_longest + 1, 0);
+		for (int length : lengths) e.left[length]++;
+		e.blocked.assign(lengths.size() + 1, BitBoard(_cellCount));
+		e.covered.assign(lengths.size() + 1, BitBoard(_cellCount));
+		for (int c = 0; c < _cellCount; ++c) {
+			if (known[c] == CELL_HIT) e.hitCells.push_back(c);
+			if (known[c] == CELL_EMPTY) e.blocked[0].set(c);
+		}
+
+		e.run(0, 0, -1);
+		problem.layoutCount = e.count;
+		return !e.tooMany;
+	}
+
+public:
+	EndgameSolver(int size, const vector<int>& shipLengths)
+		: _size(size), _cellCount(size * size), _maskWords((size * size + 63) / 64),
+		_longest(shipLengths.empty() ? 1 : *max_element(shipLengths.begin(), shipLengths.end())),
+		_table(PlacementTable::get(size, _longest)) {
+	}
+
+	// Best cell to fire at, or -1 when there are too many layouts to solve
+	// exactly, none at all, or the search did not finish by the deadline
+	// (or before *stop was set). afloat is the ships not yet sunk, longest
+	// first, out of the fleet the solver was built for. Root shots are
+	// shared out over threads, each with its own memo.
+	int solve(const vector<char>& known, const vector<int>& afloat, chrono::microseconds budget, int threads,
+		const atomic<bool>* stop = nullptr) const {
+		auto deadline = chrono::steady_clock::now() + budget;
+		Problem problem;
+		if (!enumerate(known, afloat, problem) || problem.layoutCount == 0) return -1;
+
+		// Sure hits first, and sort the rest into disputed cells
+		for (int c = 0; c < _cellCount; ++c) {
+			if (known[c] != CELL_UNKNOWN) continue;
+
+			LayoutSet ships = {};
+			for (int l = 0; l < problem.layoutCount; ++l) {
+				if ((problem.layouts[l * _maskWords + (c >> 6)] >> (c & 63)) & 1) ships.bits[l >> 6] |= 1ULL << (l & 63);
+			}
+			int count = ships.size();
+			if (count == problem.layoutCount) return c;
+			if (count > 0) {
+				problem.cells.push_back(c);
+				problem.withShip.push_back(ships);
+			}
+		}
+		if (problem.cells.empty()) return -1;
+		for (int l = 0; l < problem.layoutCount; ++l) problem.all.bits[l >> 6] |= 1ULL << (l & 63);
+
+		// Kök atəşləri axınlar arasında bölünür; hər axının öz yaddaşı var
+		atomic<bool> cancelled(false);
+		atomic<bool> timedOut(false);
+		Search ranking(problem, deadline, cancelled, stop);
+		vector<Shot> ranked = ranking.rank(problem.all, problem.layoutCount, 0);
+		threads = max(1, min(threads, static_cast<int>(ranked.size())));
+		vector<double> values(problem.cells.size(), numeric_limits<double>::max());
+		mutex bestMutex;
+		double best = numeric_limits<double>::max();
+
+		// Shots are dealt out likeliest hit first; one whose miss chance alone
+		// is above the best value found so far cannot win and is skipped
+		auto work = [&](int t) {
+			Search search(problem, deadline, cancelled, stop);
+			for (size_t k = t; k < ranked.size(); k += threads) {
+				{
+					lock_guard<mutex> lock(bestMutex);
+					if (ranked[k].missChance > best) return;
+				}
+				double value = search.value(ranked[k], problem.layoutCount, 0);
+				if (search.timedOut) {
+					timedOut.store(true);
+					cancelled.store(true);
+					return;
+				}
+				values[ranked[k].cell] = value;
+				lock_guard<mutex> lock(bestMutex);
+				best = min(best, value);
+			}
+		};
+
+		vector<future<void>> pending;
+		for (int t = 1; t < threads; ++t) {
+			pending.push_back(ThreadPool::shared().submit([&work, t] { work(t); }));
+		}
+		work(0);
+		for (auto& task : pending) {
+			task.get();
+		}
+		if (timedOut.load()) return -1;
+
+		// Ties go to the lowest cell, whichever thread finished first
+		for (size_t i = 0; i < problem.cells.size(); ++i) {
+			if (values[i] == best) return problem.cells[i];
+		}
+		return -1;
+	}
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+// Portable game engine: no console or Windows dependencies, so it can be
+// built on its own (benchmarks, headless simulation on Linux).
+#include "constants.h"
+#include "metrics.h"
+#include "events.h"
+#include "fleet.h"
+#include "priorTable.h"
+#include "point.h"
+#include "ship.h"
+#include "bitBoard.h"
+#include "binaryIO.h"
+#include "boardConfig.h"
+#include "rng.h"
+#include "board.h"
+#include "gameState.h"
+#include "placementTable.h"
+#include "fleetSampler.h"
+#include "playerBase.h"
+#include "densityMap.h"
+#include "threadPool.h"
+#include "monteCarlo.h"
+#include "endgameSolver.h"
+#include "computerPlayer.h"
+#include "gameRecord.h"
+#include "savedGame.h"
+#include "gameDriver.h"
+#include "simulation.h"
+#include "randomPlayer.h"
+#include "workStealing.h"
+#include "tournament.h"
+#include "sessionPool.h"
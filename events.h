@@ -0,0 +1,93 @@
+#pragma once
+
+
+// What the engine reports instead of printing. The engine only pushes
+// events; whoever shows, logs or records a game drains them in its own time.
+enum class GameEventType : uint8_t {
+	ShotFired,        // Lövhəyə atəş açıldı, nəticədən əvvəl
+	Hit,
+	Miss,
+	ShotRejected,     // Lövhədən kənar və ya artıq atəş açılmış hüceyrə
+	ShipSunk,         // ship - lövhədəki indeksi, length - uzunluğu
+	GameOver,         // seat - qalib
+	FleetPlaced,
+	PlacementFailed
+};
+
+// seat is the board the event happened on (0 - first player, 1 - second),
+// except for GameOver, where it is the winner
+struct GameEvent {
+	GameEventType type;
+	int8_t seat;
+	short x, y;
+	short ship, length;
+};
+
+
+// Single-producer, single-consumer ring of events. The game thread pushes,
+// one reader pops - on the same thread or another one. Neither side locks
+// or waits: a full ring drops the new event and counts it, so a slow or
+// absent reader never holds up the game.
+class EventRing {
+public:
+	static const size_t CAPACITY = 1024; // 2-nin qüvvəti olmalıdır
+
+private:
+	GameEvent _slots[CAPACITY];
+
+	// On separate cache lines so the two sides do not keep stealing each other's
+	alignas(64) atomic<size_t> _head;    // Yazılacaq növbəti yer - yalnız yazan dəyişir
+	alignas(64) atomic<size_t> _tail;    // Oxunacaq növbəti yer - yalnız oxuyan dəyişir
+	alignas(64) atomic<uint64_t> _dropped;
+
+public:
+	EventRing() : _head(0), _tail(0), _dropped(0) {
+	}
+
+	EventRing(const EventRing&) = delete;
+	EventRing& operator=(const EventRing&) = delete;
+
+	bool push(const GameEvent& event) {
+		size_t head = _head.load(memory_order_relaxed);
+		if (head - _tail.load(memory_order_acquire) == CAPACITY) {
+			_dropped.store(_dropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+			return false;
+		}
+		_slots[head & (CAPACITY - 1)] = event;
+		_head.store(head + 1, memory_order_release);
+		return true;
+	}
+
+	bool pop(GameEvent& event) {
+		size_t tail = _tail.load(memory_order_relaxed);
+		if (tail == _head.load(memory_order_acquire)) return false;
+		event = _slots[tail & (CAPACITY - 1)];
+		_tail.store(tail + 1, memory_order_release);
+		return true;
+	}
+
+	// Hands every waiting event to handle(); returns how many there were
+	template <class Handler>
+	int drain(Handler handle) {
+		GameEvent event;
+		int count = 0;
+		while (pop(event)) {
+			handle(event);
+			++count;
+		}
+		return count;
+	}
+
+	// Events lost to a full ring
+	uint64_t dropped() const {
+		return _dropped.load(memory_order_relaxed);
+	}
+
+	// Producer side helper: a no-op without a ring, so headless code pays one test
+	static void emit(EventRing* ring, GameEventType type, int seat, int x = -1, int y = -1, int ship = -1, int length = 0) {
+		if (ring) {
+			ring->push(GameEvent{ type, static_cast<int8_t>(seat), static_cast<short>(x), static_cast<short>(y),
+				static_cast<short>(ship), static_cast<short>(length) });
+		}
+	}
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+
+// Board size of the standard game
+const int STANDARD_BOARD_SIZE = 10;
+
+// Fleet as a compile-time list of ship lengths, longest first
+template <int... Lengths>
+struct Fleet {
+	static constexpr int COUNT = sizeof...(Lengths);
+
+	static constexpr int length(int i) {
+		const int values[] = { Lengths... };
+		return values[i];
+	}
+
+	static constexpr int longest() {
+		int best = 0;
+		for (int i = 0; i < COUNT; ++i) best = length(i) > best ? length(i) : best;
+		return best;
+	}
+
+	static constexpr bool isLongestFirst() {
+		for (int i = 1; i < COUNT; ++i) {
+			if (length(i) > length(i - 1)) return false;
+		}
+		return true;
+	}
+
+	static vector<int> lengths() {
+		return { Lengths... };
+	}
+};
+
+// 1x4, 2x3, 3x2, 4x1
+typedef Fleet<4, 3, 3, 2, 2, 2, 1, 1, 1, 1> StandardFleet;
+
+// Ships per length of a fleet chosen at run time: how many the fleet has,
+// and how many are left, as players track them during placement. Fleets
+// no longer than the standard one keep both counts in a fixed array; a
+// fleet with longer ships falls back to the heap.
+class FleetCounts {
+private:
+	static const int INLINE_LENGTHS = StandardFleet::longest() + 1;
+
+	int _lengths;                       // En uzun gəmi + 1
+	int _inline[2 * INLINE_LENGTHS];    // Donanmadakı say, sonra qalan say
+	vector<int> _heap;
+
+	int* data() { return _lengths <= INLINE_LENGTHS ? _inline : _heap.data(); }
+	const int* data() const { return _lengths <= INLINE_LENGTHS ? _inline : _heap.data(); }
+
+public:
+	explicit FleetCounts(const vector<int>& lengths) : _lengths(1) {
+		for (int length : lengths) _lengths = max(_lengths, length + 1);
+		if (_lengths > INLINE_LENGTHS) _heap.resize(2 * _lengths);
+		fill(data(), data() + _lengths, 0);
+		for (int length : lengths) data()[length]++;
+		reset();
+	}
+
+	int getLongest() const { return _lengths - 1; }
+
+	// Ships of this length in the whole fleet
+	int inFleet(int length) const {
+		return length > 0 && length < _lengths ? data()[length] : 0;
+	}
+
+	// Every ship left again
+	void reset() {
+		copy(data(), data() + _lengths, data() + _lengths);
+	}
+
+	// Ships of this length left; only for lengths up to getLongest()
+	int& operator[](int length) { return data()[_lengths + length]; }
+	int operator[](int length) const { return data()[_lengths + length]; }
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+
+// Draws complete fleet layouts without trial-and-error placement. For each
+// ship (longest first) the legal placements left by the ships already placed
+// are enumerated and one is drawn uniformly. That alone favours layouts
+// where the first ships left the others little room: a layout comes out with
+// chance 1 / (product of the choice counts), so the product is its
+// importance weight. draw() makes POOL such layouts and keeps one with
+// chance proportional to its weight, which takes most of the bias out
+// (worst cell of the standard board off by about 0.014 instead of 0.053)
+// at no retries. A draw only starts over if every layout in the pool ran
+// into a ship with no legal placement at all, which the standard fleet on
+// a 10x10 board practically never hits.
+class FleetSampler {
+private:
+	static const int POOL = 8;
+	static const int MAX_RESTARTS = 1000;
+
+	shared_ptr<const PlacementTable> _table;
+	vector<int> _lengths;       // Azalan sırada
+	BitBoard _blocked;
+	vector<int> _candidates;
+	vector<int> _pool;          // POOL düzülüş, hər birində gəmi başına bir yerləşmə
+	double _weights[POOL];
+	long long _restarts;
+	bool _standard;             // Standart lövhə və donanma - StandardConfig cədvəlləri
+
+	// Word w of bits moved down by shift cells: bit c is bit c + shift of bits
+	template <int Words>
+	static uint64_t shiftedWord(const uint64_t* bits, int shift, int w) {
+		int from = w + (shift >> 6), offset = shift & 63;
+		uint64_t low = from < Words ? bits[from] >> offset : 0;
+		uint64_t high = (offset != 0 && from + 1 < Words) ? bits[from + 1] << (64 - offset) : 0;
+		return low | high;
+	}
+
+	// All free placements of one length at once: a start is free when each
+	// of its Length cells is, so the free cells are ANDed with themselves
+	// moved by one step along the ship. Returns how many there were.
+	template <class Config, int Length>
+	static double drawFixedShip(Rng& rng, int& placement, uint64_t* blocked) {
+		constexpr int WORDS = Config::WORDS;
+		uint64_t starts[2][WORDS];
+		int count = 0;
+		for (int d = 0; d < 2; ++d) {
+			int step = d == 0 ? 1 : Config::SIZE;
+			for (int w = 0; w < WORDS; ++w) {
+				uint64_t bits = ~blocked[w] & Config::tables.startMasks[Length][d][w];
+				for (int i = 1; i < Length; ++i) bits &= ~shiftedWord<WORDS>(blocked, i * step, w);
+				starts[d][w] = bits;
+				count += popCount(bits);
+			}
+		}
+		if (count == 0) return 0;
+
+		// k-ci başlanğıc: sözləri keç, sonra sözdə k ən aşağı biti sil
+		int k = rng.nextInt(count);
+		for (int d = 0; d < 2; ++d) {
+			for (int w = 0; w < WORDS; ++w) {
+				uint64_t bits = starts[d][w];
+				int inWord = popCount(bits);
+				if (k >= inWord) {
+					k -= inWord;
+					continue;
+				}
+				for (; k > 0; --k) bits &= bits - 1;
+				placement = Config::tables.placementAt[Length][d][w * 64 + countTrailingZeros(bits)];
+				for (int h = 0; h < WORDS; ++h) blocked[h] |= Config::tables.haloMasks[placement][h];
+				return count;
+			}
+		}
+		return 0;
+	}
+
+	// drawSequential() on a configuration known at compile time: ship lengths,
+	// placement ranges and mask sizes are constants, so the loop over the
+	// ships unrolls and the blocked cells stay in registers
+	template <class Config, size_t... Ship>
+	static double drawFixed(Rng& rng, int* placements, index_sequence<Ship...>) {
+		uint64_t blocked[Config::WORDS] = {};
+		double weight = 1;
+		(((weight *= drawFixedShip<Config, Config::FleetType::length(Ship)>(rng, placements[Ship], blocked)) > 0) && ...);
+		return weight;
+	}
+
+	// Each ship uniformly among the placements still free. Returns the
+	// layout's weight, the product of the choice counts, or 0 at a dead end.
+	double drawSequential(Rng& rng, int* placements) {
+		if (_standard) return drawFixed<StandardConfig>(rng, placements, make_index_sequence<StandardFleet::COUNT>());
+
+		_blocked.clear();
+		double weight = 1;
+		for (size_t s = 0; s < _lengths.size(); ++s) {
+			const vector<int>& options = _table->withLength(_lengths[s]);
+			_candidates.resize(options.size());
+
+			// Budaqsız yazılış: sərbəst olmayanların üzərinə növbəti yazılır
+			int count = 0;
+			for (int p : options) {
+				_candidates[count] = p;
+				count += _table->isFree(p, _blocked);
+			}
+			if (count == 0) return 0;
+
+			placements[s] = _candidates[rng.nextInt(count)];
+			_table->occupy(placements[s], _blocked);
+			weight *= count;
+		}
+		return weight;
+	}
+
+	// Depth-first search for any legal layout; ships of equal length take
+	// increasing placements, so no layout is tried twice in another order
+	static bool fitsFrom(const PlacementTable& table, const vector<int>& lengths, size_t ship, size_t from,
+		vector<BitBoard>& blocked) {
+		if (ship == lengths.size()) return true;
+
+		const vector<int>& options = table.withLength(lengths[ship]);
+		bool nextSame = ship + 1 < lengths.size() && lengths[ship + 1] == lengths[ship];
+		for (size_t i = from; i < options.size(); ++i) {
+			if (!table.isFree(options[i], blocked[ship])) continue;
+			blocked[ship + 1] = blocked[ship];
+			table.occupy(options[i], blocked[ship + 1]);
+			if (fitsFrom(table, lengths, ship + 1, nextSame ? i + 1 : 0, blocked)) return true;
+		}
+		return false;
+	}
+
+public:
+	// Whether the fleet has any legal layout on a size x size board
+	static bool fits(int size, const vector<int>& shipLengths) {
+		vector<int> lengths(shipLengths);
+		sort(lengths.begin(), lengths.end(), greater<int>());
+		if (lengths.empty()) return true;
+		if (size < 1 || lengths.front() > size) return false;
+
+		shared_ptr<const PlacementTable> table = PlacementTable::get(size, lengths.front());
+		vector<BitBoard> blocked(lengths.size() + 1, BitBoard(size * size));
+		return fitsFrom(*table, lengths, 0, 0, blocked);
+	}
+
+	// For constructors that set up games on a board of a given size
+	static void requireFit(int size, const vector<int>& shipLengths) {
+		if (!fits(size, shipLengths)) {
+			throw invalid_argument("The fleet does not fit on a " + to_string(size) + "x" + to_string(size) + " board");
+		}
+	}
+
+	FleetSampler(int size, const vector<int>& shipLengths)
+		: _lengths(shipLengths), _blocked(size * size), _restarts(0), _standard(false) {
+		sort(_lengths.begin(), _lengths.end(), greater<int>());
+		_table = PlacementTable::get(size, _lengths.empty() ? 1 : _lengths.front());
+		_standard = size == StandardConfig::SIZE && _lengths == StandardFleet::lengths() &&
+			_table->count() == StandardConfig::PLACEMENTS;
+		_pool.resize(POOL * _lengths.size());
+	}
+
+	const PlacementTable& getTable() const { return *_table; }
+	long long getRestarts() const { return _restarts; }
+
+	// One placement index per ship, longest ship first
+	bool draw(Rng& rng, vector<int>& placements) {
+		size_t ships = _lengths.size();
+		for (int attempt = 0; attempt < MAX_RESTARTS; ++attempt) {
+			double total = 0;
+			for (int k = 0; k < POOL; ++k) {
+				_weights[k] = drawSequential(rng, &_pool[k * ships]);
+				total += _weights[k];
+			}
+
+			if (total > 0) {
+				// Çəkiyə mütənasib seçim; çıxılmaza düşənlərin çəkisi sıfırdır
+				double pick = rng.nextDouble() * total;
+				int chosen = 0;
+				for (int k = 0; k < POOL; ++k) {
+					if (_weights[k] == 0) continue;
+					chosen = k;
+					if (pick < _weights[k]) break;
+					pick -= _weights[k];
+				}
+				placements.assign(_pool.begin() + chosen * ships, _pool.begin() + (chosen + 1) * ships);
+				return true;
+			}
+			++_restarts;
+			Metrics::count(Counter::PlacementRestarts);
+		}
+		return false;
+	}
+
+	// Draws a fleet and places it on an empty board
+	bool placeFleet(Board& board, Rng& rng, vector<int>& placements) {
+		if (!draw(rng, placements)) return false;
+		for (int p : placements) {
+			board.placeShip(_table->getStart(p), _table->getLength(p), _table->isHorizontal(p));
+		}
+		return true;
+	}
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+
+struct GameResult {
+	int winner;      // 0 - birinci oyunçu, 1 - ikinci, -1 - heç-heçə (atəş limiti)
+	int shots;       // Qalibin etdiyi atəşlərin sayı
+	int totalShots;  // Hər iki oyunçunun atəşləri
+};
+
+// Headless turn loop, templated on the two player types. A player type
+// only needs selectAttack(), processAttackResult() and getBoard(). With
+// final classes such as ComputerPlayer every call in the loop is resolved
+// at compile time and can be inlined. With Player itself the same code
+// goes through the virtual interface, which mixed modes still use.
+template <class First, class Second>
+class GameDriver {
+private:
+	template <class Shooter, class Target>
+	static bool fire(Shooter& shooter, Target& target, GameRecord* record) {
+		Point attack = shooter.selectAttack();
+		AttackResult result = target.getBoard().attack(attack);
+		shooter.processAttackResult(attack, result);
+		if (record) record->addShot(attack, result.isHit());
+		return result.isHit();
+	}
+
+	// One salvo turn: the shooter fires one shot per ship it has afloat and
+	// learns every result at once. Returns the number of shots fired.
+	template <class Shooter, class Target>
+	static int volley(Shooter& shooter, Target& target, vector<Point>& salvo) {
+		AttackResult results[64];
+		shooter.selectAttacks(shooter.getBoard().getShipsAfloat(), salvo);
+		target.getBoard().attackBatch(salvo, results);
+		for (size_t i = 0; i < salvo.size(); ++i) {
+			shooter.processAttackResult(salvo[i], results[i]);
+		}
+		return static_cast<int>(salvo.size());
+	}
+
+public:
+	// Same turn rules as Game::start: a hit earns another shot, a miss passes the turn.
+	// With a record, every shot is also logged to it.
+	static GameResult play(First& first, Second& second, int boardSize, GameRecord* record = nullptr) {
+		int shots[2] = { 0, 0 };
+		int current = 0;
+		const int maxShots = 4 * boardSize * boardSize;
+
+		while (shots[0] + shots[1] < maxShots) {
+			// Hər oyunçu öz tipi ilə çağırılır - virtual çağırış yoxdur
+			bool hit = current == 0 ? fire(first, second, record) : fire(second, first, record);
+			shots[current]++;
+
+			bool sunk = current == 0 ? second.getBoard().allShipsSunk() : first.getBoard().allShipsSunk();
+			if (sunk) {
+				Metrics::count(Counter::GamesPlayed);
+				return GameResult{ current, shots[current], shots[0] + shots[1] };
+			}
+			if (!hit) current = 1 - current;
+		}
+		Metrics::count(Counter::GamesPlayed);
+		return GameResult{ -1, 0, shots[0] + shots[1] };
+	}
+
+	// Salvo variant: the turn always passes, hit or miss. Not recorded -
+	// GameRecord replays assume a hit earns another shot.
+	static GameResult playSalvo(First& first, Second& second, int boardSize) {
+		static thread_local vector<Point> salvo; // Oyunlar arasında yenidən istifadə olunur
+		int shots[2] = { 0, 0 };
+		int current = 0;
+		const int maxShots = 4 * boardSize * boardSize;
+
+		while (shots[0] + shots[1] < maxShots) {
+			int fired = current == 0 ? volley(first, second, salvo) : volley(second, first, salvo);
+			shots[current] += fired;
+
+			bool sunk = current == 0 ? second.getBoard().allShipsSunk() : first.getBoard().allShipsSunk();
+			if (sunk) {
+				Metrics::count(Counter::GamesPlayed);
+				return GameResult{ current, shots[current], shots[0] + shots[1] };
+			}
+			if (fired == 0) break; // Heç kim atəş aça bilmir
+			current = 1 - current;
+		}
+		Metrics::count(Counter::GamesPlayed);
+		return GameResult{ -1, 0, shots[0] + shots[1] };
+	}
+};
@@ -0,0 +1,346 @@
+#pragma once
+
+
+// Compact log of one game: seed, both fleets and the shot stream.
+// Only the target cell of each shot is stored (one byte on boards up to
+// 16x16). Who fired and whether it hit are implied by the fleets and the
+// turn rule (a hit shoots again). Every keyframeInterval shots a keyframe
+// stores the attacked cells of both boards and the player to shoot, so a
+// replay can jump close to any turn and play forward from there.
+class GameRecord {
+public:
+	static const int DEFAULT_KEYFRAME_INTERVAL = 32;
+
+	struct Keyframe {
+		int shooter;            // Növbəti atəşi açan oyunçu
+		BitBoard attacked[2];   // attacked[i] - i-ci oyunçunun lövhəsinə atılan atəşlər
+	};
+
+private:
+	uint64_t _gameIndex;
+	uint64_t _seed;
+	int _boardSize;
+	int _keyframeInterval;
+	int _winner;                // -1 - qalib yoxdur
+	vector<Ship> _fleets[2];
+	vector<uint16_t> _shots;    // Hədəf hüceyrənin indeksi (y * size + x)
+	vector<Keyframe> _keyframes; // _keyframes[k] - k * interval atəşdən əvvəlki vəziyyət
+	Keyframe _live;             // Yazılış zamanı cari vəziyyət
+
+	int cellCount() const { return _boardSize * _boardSize; }
+	int maskBytes() const { return (cellCount() + 7) / 8; }
+	int shotBytes() const { return cellCount() <= 256 ? 1 : 2; }
+
+	void resetLive() {
+		_live.shooter = 0;
+		for (int i = 0; i < 2; ++i) _live.attacked[i] = BitBoard(cellCount());
+	}
+
+public:
+	GameRecord()
+		: _gameIndex(0), _seed(0), _boardSize(0),
+		_keyframeInterval(DEFAULT_KEYFRAME_INTERVAL), _winner(-1) {
+	}
+
+	// Starts a new record from the fleets already on both boards
+	void start(uint64_t gameIndex, uint64_t seed, const Board& first, const Board& second,
+		int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL) {
+		if (keyframeInterval < 1) throw invalid_argument("Keyframe interval must be positive");
+		_gameIndex = gameIndex;
+		_seed = seed;
+		_boardSize = first.getBoardSize();
+		_keyframeInterval = keyframeInterval;
+		_winner = -1;
+		_fleets[0] = first.getShips();
+		_fleets[1] = second.getShips();
+		_shots.clear();
+		resetLive();
+		_keyframes.assign(1, _live);
+	}
+
+	// hit decides who fires next, exactly like the game loop
+	void addShot(const Point& p, bool hit) {
+		if (p.getX() < 0 || p.getX() >= _boardSize || p.getY() < 0 || p.getY() >= _boardSize) {
+			throw invalid_argument("Shot outside the board cannot be recorded");
+		}
+		int target = 1 - _live.shooter;
+		_shots.push_back(static_cast<uint16_t>(p.getY() * _boardSize + p.getX()));
+		_live.attacked[target].set(p.getY() * _boardSize + p.getX());
+		if (!hit) _live.shooter = target;
+
+		if (_shots.size() % _keyframeInterval == 0) _keyframes.push_back(_live);
+	}
+
+	void finish(int winner) {
+		_winner = winner;
+	}
+
+	uint64_t getGameIndex() const { return _gameIndex; }
+	uint64_t getSeed() const { return _seed; }
+	int getBoardSize() const { return _boardSize; }
+	int getWinner() const { return _winner; }
+	int getKeyframeInterval() const { return _keyframeInterval; }
+	int getShotCount() const { return static_cast<int>(_shots.size()); }
+	const vector<Ship>& getFleet(int player) const { return _fleets[player]; }
+	const vector<Keyframe>& getKeyframes() const { return _keyframes; }
+
+	Point getShot(int turn) const {
+		return Point(_shots[turn] % _boardSize, _shots[turn] / _boardSize);
+	}
+
+	// Keyframe 0 (empty boards) is implied and not written
+	void write(BinaryWriter& out) const {
+		out.writeVarint(_gameIndex);
+		out.writeU64(_seed);
+		out.writeU8(static_cast<uint8_t>(_boardSize));
+		out.writeVarint(static_cast<uint64_t>(_keyframeInterval));
+		out.writeU8(static_cast<uint8_t>(_winner + 1));
+
+		for (const auto& fleet : _fleets) {
+			out.writeVarint(fleet.size());
+			for (const Ship& ship : fleet) {
+				out.writeVarint(static_cast<uint64_t>(ship.getStart().getY() * _boardSize + ship.getStart().getX()));
+				out.writeU8(static_cast<uint8_t>((ship.getLength() << 1) | (ship.isHorizontal() ? 1 : 0)));
+			}
+		}
+
+		out.writeVarint(_shots.size());
+		for (uint16_t shot : _shots) {
+			out.writeU8(static_cast<uint8_t>(shot));
+			if (shotBytes() == 2) out.writeU8(static_cast<uint8_t>(shot >> 8));
+		}
+
+		for (size_t k = 1; k < _keyframes.size(); ++k) {
+			out.writeU8(static_cast<uint8_t>(_keyframes[k].shooter));
+			out.writeBits(_keyframes[k].attacked[0], maskBytes());
+			out.writeBits(_keyframes[k].attacked[1], maskBytes());
+		}
+	}
+
+	void read(BinaryReader& in) {
+		_gameIndex = in.readVarint();
+		_seed = in.readU64();
+		_boardSize = in.readU8();
+		_keyframeInterval = static_cast<int>(in.readVarint());
+		_winner = static_cast<int>(in.readU8()) - 1;
+		if (_boardSize < 1 || _keyframeInterval < 1 || _winner > 1) {
+			throw runtime_error("Corrupt game record header");
+		}
+
+		for (auto& fleet : _fleets) {
+			uint64_t count = in.readVarint();
+			if (count > static_cast<uint64_t>(cellCount())) throw runtime_error("Corrupt fleet in game record");
+			fleet.clear();
+			for (uint64_t i = 0; i < count; ++i) {
+				uint64_t cell = in.readVarint();
+				uint8_t shape = in.readU8();
+				if (cell >= static_cast<uint64_t>(cellCount())) throw runtime_error("Corrupt fleet in game record");
+				Point start(static_cast<int>(cell % _boardSize), static_cast<int>(cell / _boardSize));
+				fleet.push_back(Ship(start, (shape & 1) != 0, shape >> 1));
+			}
+		}
+
+		uint64_t shots = in.readVarint();
+		if (shots > in.remaining()) throw runtime_error("Corrupt shot stream in game record");
+		_shots.resize(static_cast<size_t>(shots));
+		for (auto& shot : _shots) {
+			shot = in.readU8();
+			if (shotBytes() == 2) shot |= static_cast<uint16_t>(in.readU8() << 8);
+			if (shot >= cellCount()) throw runtime_error("Corrupt shot stream in game record");
+		}
+
+		resetLive();
+		_keyframes.assign(1, _live);
+		for (size_t k = 1; k <= _shots.size() / _keyframeInterval; ++k) {
+			Keyframe keyframe = _live;
+			keyframe.shooter = in.readU8() & 1;
+			in.readBits(keyframe.attacked[0], maskBytes());
+			in.readBits(keyframe.attacked[1], maskBytes());
+			_keyframes.push_back(keyframe);
+		}
+	}
+};
+
+
+// Player that puts a recorded fleet back on its board. Its shots come from
+// the record, so it never chooses anything itself.
+class ReplayPlayer final : public Player {
+private:
+	vector<Ship> _fleet;
+
+public:
+	ReplayPlayer(Board& board) : Player(board, Rng(0)) {
+	}
+
+	void setFleet(const vector<Ship>& fleet) {
+		_fleet = fleet;
+	}
+
+	void placeShips(bool autoPlace = false) override {
+		for (const Ship& ship : _fleet) {
+			if (!board.placeShip(ship.getStart(), ship.getLength(), ship.isHorizontal())) {
+				throw runtime_error("Recorded fleet does not fit on the board");
+			}
+		}
+	}
+
+	void takeTurn() override {
+	}
+};
+
+
+// Plays a GameRecord back through Board::attack and
+// Player::processAttackResult. seek() starts from the nearest keyframe at
+// or before the wanted turn, so it costs at most keyframeInterval shots.
+class GameReplay {
+private:
+	const GameRecord& _record;
+	Board _emptyBoard;
+	ReplayPlayer _first;
+	ReplayPlayer _second;
+	Player* _players[2];
+	int _turn;
+	int _shooter;
+
+	void restart() {
+		for (int i = 0; i < 2; ++i) {
+			_players[i]->reset();
+			_players[i]->placeShips();
+		}
+		_turn = 0;
+		_shooter = 0;
+	}
+
+	// Shots on each board in cell order - the resulting state does not depend on order
+	void applyKeyframe(int k) {
+		const GameRecord::Keyframe& keyframe = _record.getKeyframes()[k];
+		int size = _record.getBoardSize();
+		for (int target = 0; target < 2; ++target) {
+			const BitBoard& attacked = keyframe.attacked[target];
+			for (int w = 0; w < attacked.getWordCount(); ++w) {
+				uint64_t word = attacked.getWord(w);
+				while (word) {
+					int cell = w * 64 + countTrailingZeros(word);
+					word &= word - 1;
+					Point p(cell % size, cell / size);
+					_players[1 - target]->processAttackResult(p, _players[target]->getBoard().attack(p));
+				}
+			}
+		}
+		_turn = k * _record.getKeyframeInterval();
+		_shooter = keyframe.shooter;
+	}
+
+public:
+	GameReplay(const GameRecord& record)
+		: _record(record), _emptyBoard(record.getBoardSize()),
+		_first(_emptyBoard), _second(_emptyBoard), _turn(0), _shooter(0) {
+		_players[0] = &_first;
+		_players[1] = &_second;
+		_first.setFleet(record.getFleet(0));
+		_second.setFleet(record.getFleet(1));
+		restart();
+	}
+
+	int getTurn() const { return _turn; }
+	int getShooter() const { return _shooter; }
+	bool isFinished() const { return _turn >= _record.getShotCount(); }
+	Player& getPlayer(int i) { return *_players[i]; }
+
+	// Plays the next recorded shot; false when the record is over
+	bool step() {
+		if (isFinished()) return false;
+		Point p = _record.getShot(_turn);
+		AttackResult result = _players[1 - _shooter]->getBoard().attack(p);
+		_players[_shooter]->processAttackResult(p, result);
+		if (!result.isHit()) _shooter = 1 - _shooter;
+		++_turn;
+		return true;
+	}
+
+	// State after the first `turn` shots
+	void seek(int turn) {
+		turn = max(0, min(turn, _record.getShotCount()));
+		int k = min(turn / _record.getKeyframeInterval(),
+			static_cast<int>(_record.getKeyframes().size()) - 1);
+
+		restart();
+		if (k > 0) applyKeyframe(k);
+		while (_turn < turn) step();
+	}
+};
+
+
+// Archive file: a header followed by length-prefixed game records, so
+// readers can skip a game without decoding it. Records are appended, and
+// several processes or threads can add to the same archive over time.
+class GameArchiveWriter {
+private:
+	ofstream _out;
+	mutex _lock;
+
+public:
+	static const uint32_t MAGIC = 0x41475342; // "BSGA"
+	static const uint8_t VERSION = 1;
+
+	GameArchiveWriter(const string& path) {
+		_out.open(path, ios::binary | ios::app);
+		if (!_out) throw runtime_error("Cannot open " + path);
+		_out.seekp(0, ios::end);
+		if (_out.tellp() == 0) {
+			BinaryWriter header;
+			header.writeU32(MAGIC);
+			header.writeU8(VERSION);
+			append(header);
+		}
+	}
+
+	// Adds already encoded records (see encode()) in one write
+	void append(const BinaryWriter& encoded) {
+		lock_guard<mutex> guard(_lock);
+		_out.write(reinterpret_cast<const char*>(encoded.data().data()), encoded.size());
+		_out.flush();
+		if (!_out) throw runtime_error("Failed to write game archive");
+	}
+
+	// Length prefix + record, ready for append()
+	static void encode(const GameRecord& record, BinaryWriter& out, BinaryWriter& scratch) {
+		scratch.clear();
+		record.write(scratch);
+		out.writeVarint(scratch.size());
+		out.writeBytes(scratch.data().data(), scratch.size());
+	}
+};
+
+class GameArchiveReader {
+private:
+	vector<uint8_t> _data;
+	vector<pair<size_t, size_t>> _records; // Hər oyunun (başlanğıc, uzunluq)
+
+public:
+	GameArchiveReader(const string& path) {
+		ifstream in(path, ios::binary);
+		if (!in) throw runtime_error("Cannot open " + path);
+		_data.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+
+		BinaryReader reader(_data.data(), _data.size());
+		if (reader.readU32() != GameArchiveWriter::MAGIC) throw runtime_error(path + " is not a game archive");
+		if (reader.readU8() != GameArchiveWriter::VERSION) throw runtime_error("Unsupported game archive version");
+
+		// Only the length prefixes are read here; records are decoded on demand
+		while (!reader.atEnd()) {
+			size_t length = static_cast<size_t>(reader.readVarint());
+			_records.push_back(make_pair(reader.position(), length));
+			reader.skip(length);
+		}
+	}
+
+	size_t getGameCount() const { return _records.size(); }
+	size_t getRecordBytes(size_t game) const { return _records.at(game).second; }
+
+	void load(size_t game, GameRecord& record) const {
+		const auto& entry = _records.at(game);
+		BinaryReader reader(_data.data() + entry.first, entry.second);
+		record.read(reader);
+	}
+};
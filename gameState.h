@@ -0,0 +1,176 @@
+#pragma once
+
+
+// Both boards of a game in one flat, trivially copyable block: ship, hit and
+// miss bits per side, the ship under every cell and each ship's remaining
+// cells. The attack boards are the opponent's hit/miss bits and the cells
+// around its sunk ships, so they need no storage of their own. Copying a
+// snapshot is a memcpy with no allocation.
+//
+// push() fires a shot for the player to move and pop() takes it back, both
+// O(1), so a search can try a line of shots and unwind it - as far as a
+// whole game, in which both players fire at every cell at most. Boards up
+// to MAX_CELLS cells (the standard 10x10 included) and MAX_SHIPS ships per
+// fleet fit.
+class GameState {
+public:
+	static const int MAX_CELLS = 128;
+	static const int MAX_SHIPS = 16;
+	static const int MAX_DEPTH = 2 * MAX_CELLS;  // push() çağırışlarının ən çox dərinliyi
+
+	struct Side {
+		uint64_t ships[2];
+		uint64_t hits[2];
+		uint64_t misses[2];
+		int8_t shipAt[MAX_CELLS];       // -1 - boş
+		uint8_t remaining[MAX_SHIPS];
+		uint8_t length[MAX_SHIPS];
+		uint8_t shipCount;
+		uint8_t cellsAfloat;
+	};
+
+private:
+	struct Undo {
+		uint8_t cell;
+		int8_t ship;        // -1 - boş hüceyrə, -2 - artıq atəş açılmışdı (dəyişiklik yoxdur)
+		uint8_t shooter;
+	};
+
+	Side _sides[2];
+	uint8_t _size;
+	uint8_t _shooter;
+	uint16_t _depth;
+	Undo _undo[MAX_DEPTH];
+
+	static bool bit(const uint64_t* words, int cell) {
+		return (words[cell >> 6] >> (cell & 63)) & 1;
+	}
+
+	static void flip(uint64_t* words, int cell) {
+		words[cell >> 6] ^= 1ULL << (cell & 63);
+	}
+
+	static void captureSide(const Board& board, Side& side) {
+		int cells = board.getBoardSize() * board.getBoardSize();
+		const vector<Ship>& ships = board.getShips();
+		if (static_cast<int>(ships.size()) > MAX_SHIPS) throw invalid_argument("Too many ships for GameState");
+
+		for (int w = 0; w < 2; ++w) {
+			side.ships[w] = w < board.getShipMask().getWordCount() ? board.getShipMask().getWord(w) : 0;
+			side.hits[w] = w < board.getHitMask().getWordCount() ? board.getHitMask().getWord(w) : 0;
+			side.misses[w] = w < board.getMissMask().getWordCount() ? board.getMissMask().getWord(w) : 0;
+		}
+		for (int c = 0; c < MAX_CELLS; ++c) {
+			side.shipAt[c] = static_cast<int8_t>(c < cells ? board.getShipAt(c) : -1);
+		}
+		side.shipCount = static_cast<uint8_t>(ships.size());
+		side.cellsAfloat = 0;
+		for (int s = 0; s < MAX_SHIPS; ++s) {
+			bool used = s < side.shipCount;
+			side.remaining[s] = static_cast<uint8_t>(used ? ships[s].getRemaining() : 0);
+			side.length[s] = static_cast<uint8_t>(used ? ships[s].getLength() : 0);
+			side.cellsAfloat += side.remaining[s];
+		}
+	}
+
+public:
+	// Snapshot of two boards; shooter is the player to move (0 - first)
+	static GameState capture(const Board& first, const Board& second, int shooter = 0) {
+		int size = first.getBoardSize();
+		if (size * size > MAX_CELLS || second.getBoardSize() != size) {
+			throw invalid_argument("GameState holds boards up to " + to_string(MAX_CELLS) + " cells");
+		}
+
+		GameState state;
+		captureSide(first, state._sides[0]);
+		captureSide(second, state._sides[1]);
+		state._size = static_cast<uint8_t>(size);
+		state._shooter = static_cast<uint8_t>(shooter);
+		state._depth = 0;
+		return state;
+	}
+
+	int getBoardSize() const { return _size; }
+	int getShooter() const { return _shooter; }
+	int getDepth() const { return _depth; }
+	const Side& getSide(int player) const { return _sides[player]; }
+
+	bool isAttacked(int player, int cell) const {
+		const Side& side = _sides[player];
+		return bit(side.hits, cell) || bit(side.misses, cell);
+	}
+
+	// What player sees on its attack board, like Player::getAttackBoard: 'H',
+	// 'M', '.' next to a sunk ship (the no-touch rule) or '#'. '.' follows
+	// from the ships' remaining cells, so pop() takes it back with the shot.
+	char attackCell(int player, int x, int y) const {
+		const Side& target = _sides[1 - player];
+		int cell = y * _size + x;
+		if (bit(target.hits, cell)) return 'H';
+		if (bit(target.misses, cell)) return 'M';
+		for (int ny = max(y - 1, 0); ny <= min(y + 1, _size - 1); ++ny) {
+			for (int nx = max(x - 1, 0); nx <= min(x + 1, _size - 1); ++nx) {
+				int ship = target.shipAt[ny * _size + nx];
+				if (ship >= 0 && target.remaining[ship] == 0) return '.';
+			}
+		}
+		return '#';
+	}
+
+	bool isSunk(int player, int ship) const {
+		return _sides[player].remaining[ship] == 0;
+	}
+
+	bool allShipsSunk(int player) const {
+		return _sides[player].cellsAfloat == 0;
+	}
+
+	// Fires at cell for the player to move, with Board::attack's rules:
+	// a repeated shot is a miss that changes nothing. Returns true on a hit.
+	bool push(int cell) {
+		if (cell < 0 || cell >= _size * _size) throw out_of_range("GameState shot is off the board");
+		if (_depth == MAX_DEPTH) throw length_error("GameState undo stack is full");
+
+		Side& target = _sides[1 - _shooter];
+		Undo& undo = _undo[_depth++];
+		undo.cell = static_cast<uint8_t>(cell);
+		undo.shooter = _shooter;
+
+		if (bit(target.hits, cell) || bit(target.misses, cell)) {
+			undo.ship = -2;
+			_shooter = 1 - _shooter;
+			return false;
+		}
+
+		int ship = target.shipAt[cell];
+		undo.ship = static_cast<int8_t>(ship);
+		if (ship >= 0) {
+			flip(target.hits, cell);
+			target.remaining[ship]--;
+			target.cellsAfloat--;
+			return true;
+		}
+		flip(target.misses, cell);
+		_shooter = 1 - _shooter;
+		return false;
+	}
+
+	// Takes back the last push()
+	void pop() {
+		const Undo& undo = _undo[--_depth];
+		_shooter = undo.shooter;
+		if (undo.ship == -2) return;
+
+		Side& target = _sides[1 - _shooter];
+		if (undo.ship >= 0) {
+			flip(target.hits, undo.cell);
+			target.remaining[undo.ship]++;
+			target.cellsAfloat++;
+		}
+		else {
+			flip(target.misses, undo.cell);
+		}
+	}
+};
+
+static_assert(is_trivially_copyable<GameState>::value, "GameState must stay a flat copyable block");
@@ -1,11 +1,12 @@
 ﻿#pragma once
 
 
-class HumanPlayer : public Player {
+class HumanPlayer final : public Player {
 private:
-	map<int, int> _shipsLeft;
+	FleetCounts _shipsLeft;
 	vector<int> _shipLengths;
-	vector<vector<char>> _attackBoard;
+	FleetSampler _sampler;
+	vector<int> _placements;
 
 	int getValidInput(int min, int max) {
 		int input;
@@ -24,10 +25,11 @@ private:
 	}
 
 	void drawShipPreview(const Point& cursor, int length, bool horizontal) {
-		system("cls");
-		cout << "Placing ship (Length: " << length << ")\n";
-		cout << "Position: (" << cursor.getX() << "," << cursor.getY() << ")\n";
-		cout << "Orientation: " << (horizontal ? "Horizontal" : "Vertical") << "\n\n";
+		ConsoleRenderer& screen = ConsoleRenderer::shared();
+		screen.beginFrame();
+		screen.text(0, 0, "Placing ship (Length: " + to_string(length) + ")");
+		screen.text(0, 1, "Position: (" + to_string(cursor.getX()) + "," + to_string(cursor.getY()) + ")");
+		screen.text(0, 2, string("Orientation: ") + (horizontal ? "Horizontal" : "Vertical"));
 
 		const int size = board.getBoardSize();
 		bool isValidPlacement = board.canPlaceShip(cursor, length, horizontal);
@@ -51,76 +53,48 @@ private:
 
 				if (isPreviewPart) {
 					if (conflictsWithShip || !isValidPlacement) {
-						SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 12); // Qırmızı
-						cout << "X ";
+						screen.put(x * 2, y + 4, 'X', 12); // Qırmızı
 					}
 					else {
-						SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10); // Yaşıl
-						cout << "O ";
+						screen.put(x * 2, y + 4, 'O', 10); // Yaşıl
 					}
 				}
 				else {
-					SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7); // Ağ
-					cout << (board.getCell(x, y) == 'S' ? "S " : "# ");
+					screen.put(x * 2, y + 4, board.getCell(x, y) == 'S' ? 'S' : '#', 7); // Ağ
 				}
 			}
-			cout << endl;
 		}
-		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7); // Reset
 
-		cout << "\nControls: Arrow keys-Move, SHIFT-Rotate, ENTER-Place\n";
-		cout << "Legend: S=Your ship, O=Preview, X=Invalid position\n";
+		screen.text(0, size + 5, "Controls: Arrow keys-Move, SHIFT-Rotate, ENTER-Place");
+		screen.text(0, size + 6, "Legend: S=Your ship, O=Preview, X=Invalid position");
+		screen.present();
 	}
 
 
 public:
-	HumanPlayer(Board& board) : Player(board) {
-		_shipsLeft[4] = 1;
-		_shipsLeft[3] = 2;
-		_shipsLeft[2] = 3;
-		_shipsLeft[1] = 4;
-		_shipLengths = { 4, 3, 3, 2, 2, 2, 1, 1, 1, 1 };
-		_attackBoard = vector<vector<char>>(board.getBoardSize(), vector<char>(board.getBoardSize(), '#'));
+	HumanPlayer(Board& board, Rng rng = Rng(), const vector<int>& fleet = StandardFleet::lengths())
+		: Player(board, rng), _shipsLeft(fleet), _shipLengths(fleet),
+		_sampler(board.getBoardSize(), fleet) {
 	}
 
 	void reset() override {
-		board.reset();
-		_shipsLeft.clear();
-		_shipsLeft[4] = 1;
-		_shipsLeft[3] = 2;
-		_shipsLeft[2] = 3;
-		_shipsLeft[1] = 4;
-		_shipLengths = { 4, 3, 3, 2, 2, 2, 1, 1, 1, 1 };
-		_attackBoard = vector<vector<char>>(board.getBoardSize(),
-			vector<char>(board.getBoardSize(), '#'));
+		Player::reset();
+		_shipsLeft.reset();
 	}
 
 	void placeShips(bool autoPlace = false) override {
 		if (autoPlace) {
 			cout << "Auto placement selected.\n";
-			for (int length : _shipLengths) {
-				int attempts = 0;
-				const int maxAttempts = 100;
-
-				while (attempts < maxAttempts) {
-					int x = rand() % board.getBoardSize();
-					int y = rand() % board.getBoardSize();
-					bool horizontal = rand() % 2;
-
-					if (board.placeShip(Point(x, y), length, horizontal)) {
-						_shipsLeft[length]--;
-						break;
-					}
-					attempts++;
-				}
-
+			if (!_sampler.placeFleet(board, _rng, _placements)) throw runtime_error("Could not place the fleet");
+			for (int p : _placements) {
+				_shipsLeft[_sampler.getTable().getLength(p)]--;
 			}
 			cout << "All ships placed automatically!\n";
 		}
 		else {
-			system("cls");
+			ConsoleRenderer::shared().clearScreen();
 			cout << "Manual placement selected. Use arrows to move, SHIFT to rotate, ENTER to place.\n";
-			Sleep(1000);
+			Terminal::shared().waitForKey(1000);
 
 			for (int length : _shipLengths) {
 				bool placed = false;
@@ -130,7 +104,13 @@ public:
 				while (!placed) {
 					drawShipPreview(cursor, length, horizontal);
 
-					int key = _getch();
+					int key = Terminal::shared().readKey();
+					if (key == KEY_EOF) {
+						// Nobody left to place the rest by hand
+						reset();
+						placeShips(true);
+						return;
+					}
 					switch (key) {
 					case KEY_UP:
 						if (cursor.getY() > 0) cursor.decrementY();
@@ -171,12 +151,12 @@ public:
 							board.placeShip(cursor, length, horizontal);
 							_shipsLeft[length]--;
 							placed = true;
-							cout << "Ship placed successfully!\n";
-							Sleep(500);
+							cout << "Ship placed successfully!\n" << flush;
+							Terminal::shared().waitForKey(500);
 						}
 						else {
-							cout << "Cannot place ship here! Try another position!\n";
-							Sleep(1000);
+							cout << "Cannot place ship here! Try another position!\n" << flush;
+							Terminal::shared().waitForKey(1000);
 						}
 						break;
 					default:
@@ -193,7 +173,7 @@ public:
 		x = getValidInput(0, board.getBoardSize() - 1);
 		y = getValidInput(0, board.getBoardSize() - 1);
 
-		if (board.attack(Point(x, y))) {
+		if (board.attack(Point(x, y)).isHit()) {
 			cout << "Hit!\n";
 		}
 		else {
@@ -202,22 +182,23 @@ public:
 	}
 
 	void showRemainingShips() {
-		for (auto& ship : _shipsLeft) {
-			cout << "Length " << ship.first << ": " << ship.second << " ship remaining." << endl;
+		for (int length = 1; length <= _shipsLeft.getLongest(); ++length) {
+			if (_shipsLeft.inFleet(length) == 0) continue;
+			cout << "Length " << length << ": " << _shipsLeft[length] << " ship remaining." << endl;
 		}
 	}
 
 	int getRandomShipLength() {
 		vector<int> availableLengths;
-		for (auto& ship : _shipsLeft) {
-			if (ship.second > 0) {
-				availableLengths.push_back(ship.first);
+		for (int length = 1; length <= _shipsLeft.getLongest(); ++length) {
+			if (_shipsLeft[length] > 0) {
+				availableLengths.push_back(length);
 			}
 		}
 
 		if (availableLengths.empty()) return -1;
 
-		int index = rand() % availableLengths.size();
+		int index = _rng.nextInt(static_cast<int>(availableLengths.size()));
 		return availableLengths[index];
 	}
 
@@ -234,8 +215,4 @@ public:
 			cout << endl;
 		}
 	}
-
-	void processAttackResult(const Point& p, bool hit) override {
-		_attackBoard[p.getY()][p.getX()] = hit ? 'H ' : 'M ';
-	}
 };
\ No newline at end of file
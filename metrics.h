@@ -0,0 +1,306 @@
+#pragma once
+
+
+// Engine counters and latency histograms. Every thread writes only to its
+// own shard, so recording is a relaxed load and store with no lock and no
+// shared cache line; snapshot() adds the shards up. Recording is off until
+// setEnabled(true); while off, every call is a single flag check.
+enum class Counter {
+	BoardAttacks,
+	GamesPlayed,
+	PlacementRestarts,
+	KeysRead,
+	COUNT
+};
+
+enum class Histogram {
+	RenderFrame,    // beginFrame() .. present()
+	AiThink,        // ComputerPlayer::selectAttack
+	KeyToFrame,     // Düyməni oxumaqdan növbəti kadrın göstərilməsinə qədər
+	COUNT
+};
+
+// Latencies in power-of-two microsecond buckets: bucket 0 is under 1 us,
+// bucket i covers [2^(i-1), 2^i) us, the last one is open-ended.
+const int METRICS_BUCKETS = 26;
+
+struct HistogramData {
+	uint64_t count = 0;
+	uint64_t sumNs = 0;
+	uint64_t buckets[METRICS_BUCKETS] = {};
+
+	// Upper bound of the bucket holding quantile q, in microseconds
+	double quantileUs(double q) const {
+		uint64_t total = 0;
+		for (uint64_t n : buckets) total += n;
+		if (total == 0) return 0;
+
+		uint64_t rank = max<uint64_t>(static_cast<uint64_t>(ceil(q * total)), 1);
+		uint64_t seen = 0;
+		for (int b = 0; b < METRICS_BUCKETS; ++b) {
+			seen += buckets[b];
+			if (seen >= rank) return static_cast<double>(1ULL << b);
+		}
+		return static_cast<double>(1ULL << (METRICS_BUCKETS - 1));
+	}
+
+	double meanUs() const {
+		return count ? sumNs / 1000.0 / count : 0;
+	}
+};
+
+struct MetricsSnapshot {
+	uint64_t counters[static_cast<int>(Counter::COUNT)] = {};
+	HistogramData histograms[static_cast<int>(Histogram::COUNT)];
+	double uptimeSeconds = 0;
+
+	uint64_t get(Counter c) const { return counters[static_cast<int>(c)]; }
+	const HistogramData& get(Histogram h) const { return histograms[static_cast<int>(h)]; }
+
+	double gamesPerSecond() const {
+		return uptimeSeconds > 0 ? get(Counter::GamesPlayed) / uptimeSeconds : 0;
+	}
+
+	void writeJson(ostream& out) const {
+		out << "{\n  \"uptime_seconds\": " << uptimeSeconds
+			<< ",\n  \"games_per_second\": " << gamesPerSecond() << ",\n  \"counters\": {";
+		for (int c = 0; c < static_cast<int>(Counter::COUNT); ++c) {
+			out << (c ? "," : "") << "\n    \"" << counterName(static_cast<Counter>(c)) << "\": " << counters[c];
+		}
+		out << "\n  },\n  \"histograms\": {";
+		for (int h = 0; h < static_cast<int>(Histogram::COUNT); ++h) {
+			const HistogramData& data = histograms[h];
+			out << (h ? "," : "") << "\n    \"" << histogramName(static_cast<Histogram>(h)) << "\": {"
+				<< "\"count\": " << data.count << ", \"mean_us\": " << data.meanUs()
+				<< ", \"p50_us\": " << data.quantileUs(0.5) << ", \"p90_us\": " << data.quantileUs(0.9)
+				<< ", \"p99_us\": " << data.quantileUs(0.99) << ", \"buckets\": [";
+			for (int b = 0; b < METRICS_BUCKETS; ++b) out << (b ? ", " : "") << data.buckets[b];
+			out << "]}";
+		}
+		out << "\n  }\n}\n";
+	}
+
+	// Prometheus text exposition format
+	void writePrometheus(ostream& out) const {
+		for (int c = 0; c < static_cast<int>(Counter::COUNT); ++c) {
+			string name = string("battleship_") + counterName(static_cast<Counter>(c)) + "_total";
+			out << "# TYPE " << name << " counter\n" << name << " " << counters[c] << "\n";
+		}
+		out << "# TYPE battleship_games_per_second gauge\nbattleship_games_per_second " << gamesPerSecond() << "\n";
+
+		for (int h = 0; h < static_cast<int>(Histogram::COUNT); ++h) {
+			const HistogramData& data = histograms[h];
+			string name = string("battleship_") + histogramName(static_cast<Histogram>(h)) + "_seconds";
+			out << "# TYPE " << name << " histogram\n";
+			uint64_t cumulative = 0;
+			for (int b = 0; b < METRICS_BUCKETS - 1; ++b) {
+				cumulative += data.buckets[b];
+				out << name << "_bucket{le=\"" << (1ULL << b) / 1e6 << "\"} " << cumulative << "\n";
+			}
+			out << name << "_bucket{le=\"+Inf\"} " << data.count << "\n"
+				<< name << "_sum " << data.sumNs / 1e9 << "\n"
+				<< name << "_count " << data.count << "\n";
+		}
+	}
+
+	static const char* counterName(Counter c) {
+		switch (c) {
+		case Counter::BoardAttacks: return "board_attacks";
+		case Counter::GamesPlayed: return "games_played";
+		case Counter::PlacementRestarts: return "placement_restarts";
+		case Counter::KeysRead: return "keys_read";
+		default: return "unknown";
+		}
+	}
+
+	static const char* histogramName(Histogram h) {
+		switch (h) {
+		case Histogram::RenderFrame: return "render_frame";
+		case Histogram::AiThink: return "ai_think";
+		case Histogram::KeyToFrame: return "key_to_frame";
+		default: return "unknown";
+		}
+	}
+};
+
+
+class Metrics {
+private:
+	struct Shard {
+		atomic<uint64_t> counters[static_cast<int>(Counter::COUNT)];
+		atomic<uint64_t> counts[static_cast<int>(Histogram::COUNT)];
+		atomic<uint64_t> sums[static_cast<int>(Histogram::COUNT)];
+		atomic<uint64_t> buckets[static_cast<int>(Histogram::COUNT)][METRICS_BUCKETS];
+		bool inUse;
+
+		Shard() : inUse(true) {
+			for (auto& c : counters) c.store(0, memory_order_relaxed);
+			for (auto& c : counts) c.store(0, memory_order_relaxed);
+			for (auto& s : sums) s.store(0, memory_order_relaxed);
+			for (auto& row : buckets) {
+				for (auto& b : row) b.store(0, memory_order_relaxed);
+			}
+		}
+	};
+
+	// Only the owning thread writes, so no read-modify-write is needed
+	static void add(atomic<uint64_t>& value, uint64_t n) {
+		value.store(value.load(memory_order_relaxed) + n, memory_order_relaxed);
+	}
+
+	struct Registry {
+		mutex lock;
+		vector<unique_ptr<Shard>> shards;
+	};
+
+	static Registry& registry() {
+		static Registry instance;
+		return instance;
+	}
+
+	// A thread's shard goes back to the registry when the thread ends and is
+	// picked up by the next new thread, so its totals are never lost
+	class ShardHandle {
+	public:
+		Shard* shard;
+
+		ShardHandle() {
+			Registry& r = registry();
+			lock_guard<mutex> guard(r.lock);
+			for (auto& s : r.shards) {
+				if (!s->inUse) {
+					s->inUse = true;
+					shard = s.get();
+					return;
+				}
+			}
+			r.shards.emplace_back(new Shard());
+			shard = r.shards.back().get();
+		}
+
+		~ShardHandle() {
+			lock_guard<mutex> guard(registry().lock);
+			shard->inUse = false;
+		}
+	};
+
+	static Shard& local() {
+		thread_local ShardHandle handle;
+		return *handle.shard;
+	}
+
+	static atomic<bool>& enabledFlag() {
+		static atomic<bool> flag(false);
+		return flag;
+	}
+
+	static chrono::steady_clock::time_point started() {
+		static const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		return start;
+	}
+
+	static atomic<long long>& pendingInput() {
+		static atomic<long long> at(0);
+		return at;
+	}
+
+	static int bucketOf(uint64_t ns) {
+		uint64_t us = ns / 1000;
+		int bucket = 0;
+		while (us != 0 && bucket < METRICS_BUCKETS - 1) {
+			us >>= 1;
+			++bucket;
+		}
+		return bucket;
+	}
+
+public:
+	static bool enabled() {
+		return enabledFlag().load(memory_order_relaxed);
+	}
+
+	static void setEnabled(bool on) {
+		started();
+		enabledFlag().store(on);
+	}
+
+	static void count(Counter c, uint64_t n = 1) {
+		if (!enabled()) return;
+		add(local().counters[static_cast<int>(c)], n);
+	}
+
+	static void record(Histogram h, chrono::nanoseconds elapsed) {
+		if (!enabled()) return;
+		Shard& shard = local();
+		uint64_t ns = static_cast<uint64_t>(max<long long>(0, elapsed.count()));
+		int i = static_cast<int>(h);
+		add(shard.counts[i], 1);
+		add(shard.sums[i], ns);
+		add(shard.buckets[i][bucketOf(ns)], 1);
+	}
+
+	// Times a scope into a histogram; free when metrics are off
+	class Timer {
+	private:
+		Histogram _histogram;
+		bool _running;
+		chrono::steady_clock::time_point _start;
+
+	public:
+		explicit Timer(Histogram h) : _histogram(h), _running(Metrics::enabled()) {
+			if (_running) _start = chrono::steady_clock::now();
+		}
+
+		~Timer() {
+			if (_running) Metrics::record(_histogram, chrono::steady_clock::now() - _start);
+		}
+	};
+
+	// A key was read; the next frameShown() records how long it took to show its effect
+	static void inputRead() {
+		if (!enabled()) return;
+		count(Counter::KeysRead);
+		pendingInput().store(chrono::steady_clock::now().time_since_epoch().count(), memory_order_relaxed);
+	}
+
+	static void frameShown() {
+		if (!enabled()) return;
+		long long at = pendingInput().exchange(0, memory_order_relaxed);
+		if (at != 0) {
+			auto now = chrono::steady_clock::now().time_since_epoch();
+			record(Histogram::KeyToFrame, chrono::duration_cast<chrono::nanoseconds>(now - chrono::steady_clock::duration(at)));
+		}
+	}
+
+	static MetricsSnapshot snapshot() {
+		MetricsSnapshot s;
+		s.uptimeSeconds = chrono::duration<double>(chrono::steady_clock::now() - started()).count();
+
+		Registry& r = registry();
+		lock_guard<mutex> guard(r.lock);
+		for (auto& shard : r.shards) {
+			for (int c = 0; c < static_cast<int>(Counter::COUNT); ++c) {
+				s.counters[c] += shard->counters[c].load(memory_order_relaxed);
+			}
+			for (int h = 0; h < static_cast<int>(Histogram::COUNT); ++h) {
+				HistogramData& data = s.histograms[h];
+				data.count += shard->counts[h].load(memory_order_relaxed);
+				data.sumNs += shard->sums[h].load(memory_order_relaxed);
+				for (int b = 0; b < METRICS_BUCKETS; ++b) {
+					data.buckets[b] += shard->buckets[h][b].load(memory_order_relaxed);
+				}
+			}
+		}
+		return s;
+	}
+
+	// JSON if the path ends in .json, Prometheus text otherwise
+	static void dump(const string& path) {
+		ofstream file(path);
+		if (!file) throw runtime_error("Cannot open " + path);
+		MetricsSnapshot s = snapshot();
+		bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+		if (json) s.writeJson(file);
+		else s.writePrometheus(file);
+	}
+};
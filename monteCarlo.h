@@ -0,0 +1,157 @@
+#pragma once
+
+
+// Cell knowledge passed to the search, one entry per cell (y * size + x)
+enum CellKnowledge : char {
+	CELL_UNKNOWN = 0,
+	CELL_EMPTY = 1,   // Miss, və ya qaydaya görə boş olduğu bəllidir
+	CELL_HIT = 2
+};
+
+// Monte Carlo shot selection: sample whole fleet layouts consistent with
+// the attack board and fire at the unknown cell with the most ship weight.
+// Sampling runs on the shared thread pool until a hard deadline.
+//
+// Layouts are built ship by ship among the placements still legal, which
+// does not give every layout the same chance: one whose first ships left
+// the others more room comes up more often. Each layout is therefore
+// weighted by the inverse of its chance - the product of the choice counts
+// along the way - so the weighted counts estimate the uniform distribution.
+//
+// Only ships still afloat are placed. A sunk ship's cells come in as
+// CELL_EMPTY, so nothing has to cover them again.
+class MonteCarloSearch {
+private:
+	int _size;
+	int _cellCount;
+	shared_ptr<const PlacementTable> _table;
+
+	void occupy(int p, BitBoard& blocked, vector<char>& covered) const {
+		_table->occupy(p, blocked);
+		const int* cells = _table->cells(p);
+		for (int i = 0; i < _table->getLength(p); ++i) covered[cells[i]] = 1;
+	}
+
+	// One layout consistent with known; ship cells are marked in covered.
+	// Returns its weight, or 0 if the draw ran into a dead end.
+	double sampleLayout(const vector<int>& lengths, const BitBoard& empties, const vector<int>& hitCells, Rng& rng,
+		BitBoard& blocked, vector<char>& covered, vector<char>& used, vector<int>& candidates) const {
+		blocked = empties;
+		fill(covered.begin(), covered.end(), 0);
+		fill(used.begin(), used.end(), 0);
+		double weight = 1;
+
+		// Əvvəlcə vurulmuş hüceyrələri örtən gəmiləri yerləşdir
+		for (int hit : hitCells) {
+			if (covered[hit]) continue;
+
+			candidates.clear();
+			for (int p : _table->covering(hit)) {
+				if (!_table->isFree(p, blocked)) continue;
+				for (size_t s = 0; s < lengths.size(); ++s) {
+					if (!used[s] && lengths[s] == _table->getLength(p)) {
+						candidates.push_back(p);
+						break;
+					}
+				}
+			}
+			if (candidates.empty()) return 0;
+
+			weight *= static_cast<double>(candidates.size());
+			int p = candidates[rng.nextInt(static_cast<int>(candidates.size()))];
+			for (size_t s = 0; s < lengths.size(); ++s) {
+				if (!used[s] && lengths[s] == _table->getLength(p)) {
+					used[s] = 1;
+					break;
+				}
+			}
+			occupy(p, blocked, covered);
+		}
+
+		// Qalan gəmilər - boş yerlərə təsadüfi. Eyni uzunluqlu k gəmi eyni
+		// yerləşmələrə k! sırada düşə bilər, buna görə çəki k!-a bölünür.
+		int lastLength = 0, sameLength = 0;
+		for (size_t s = 0; s < lengths.size(); ++s) {
+			if (used[s]) continue;
+
+			candidates.clear();
+			for (int p : _table->withLength(lengths[s])) {
+				if (_table->isFree(p, blocked)) candidates.push_back(p);
+			}
+			if (candidates.empty()) return 0;
+
+			sameLength = lengths[s] == lastLength ? sameLength + 1 : 1;
+			lastLength = lengths[s];
+			weight *= static_cast<double>(candidates.size()) / sameLength;
+			occupy(candidates[rng.nextInt(static_cast<int>(candidates.size()))], blocked, covered);
+		}
+		return weight;
+	}
+
+	long long sampleUntil(const vector<char>& known, const vector<int>& lengths, chrono::steady_clock::time_point deadline,
+		const atomic<bool>* stop, uint64_t seed, vector<double>& counts) const {
+		Rng rng(seed);
+		BitBoard empties(_cellCount), blocked(_cellCount);
+		vector<char> covered(_cellCount), used(lengths.size());
+		vector<int> candidates;
+		vector<int> hitCells;
+		for (int c = 0; c < _cellCount; ++c) {
+			if (known[c] == CELL_HIT) hitCells.push_back(c);
+			if (known[c] == CELL_EMPTY) empties.set(c);
+		}
+
+		long long samples = 0;
+		do {
+			shuffle(hitCells.begin(), hitCells.end(), rng);
+			double weight = sampleLayout(lengths, empties, hitCells, rng, blocked, covered, used, candidates);
+			if (weight == 0) continue;
+
+			for (int c = 0; c < _cellCount; ++c) {
+				counts[c] += (covered[c] && known[c] == CELL_UNKNOWN) ? weight : 0;
+			}
+			++samples;
+		} while (chrono::steady_clock::now() < deadline && !(stop && stop->load(memory_order_relaxed)));
+		return samples;
+	}
+
+public:
+	MonteCarloSearch(int size, const vector<int>& shipLengths)
+		: _size(size), _cellCount(size * size),
+		_table(PlacementTable::get(size, shipLengths.empty() ? 1 : *max_element(shipLengths.begin(), shipLengths.end()))) {
+	}
+
+	// Best unknown cell, or -1 if no consistent layout was found in time.
+	// afloat is the ships not yet sunk, longest first, out of the fleet the
+	// search was built for. Setting *stop ends the search early with what
+	// it has so far.
+	int search(const vector<char>& known, const vector<int>& afloat, chrono::microseconds budget, int threads, uint64_t seed,
+		const atomic<bool>* stop = nullptr) const {
+		auto deadline = chrono::steady_clock::now() + budget;
+		threads = max(1, threads);
+
+		vector<vector<double>> counts(threads, vector<double>(_cellCount, 0));
+		vector<future<void>> pending;
+		for (int t = 1; t < threads; ++t) {
+			pending.push_back(ThreadPool::shared().submit([this, &known, &afloat, &counts, deadline, stop, seed, t] {
+				sampleUntil(known, afloat, deadline, stop, Rng::derive(seed, t), counts[t]);
+			}));
+		}
+		sampleUntil(known, afloat, deadline, stop, seed, counts[0]);
+		for (auto& task : pending) {
+			task.get();
+		}
+
+		int best = -1;
+		double bestCount = 0;
+		for (int c = 0; c < _cellCount; ++c) {
+			if (known[c] != CELL_UNKNOWN) continue;
+			double total = 0;
+			for (int t = 0; t < threads; ++t) total += counts[t][c];
+			if (total > bestCount) {
+				bestCount = total;
+				best = c;
+			}
+		}
+		return best;
+	}
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+
+// Every in-bounds ship placement on a square board up to a given length,
+// with the cells it covers and its no-touch halo. Tables are immutable and
+// shared between all players using the same board size.
+class PlacementTable {
+private:
+	int _size;
+	int _longest;
+
+	vector<int> _startX;
+	vector<int> _startY;
+	vector<int> _length;
+	vector<char> _horizontal;
+	vector<int> _cellFirst;         // _cells-də ilk hüceyrə
+	vector<int> _haloFirst;         // _halo-da ilk hüceyrə
+	vector<int> _haloCount;
+	vector<int> _cells;
+	vector<int> _halo;
+	vector<vector<int>> _byLength;  // Uzunluq -> yerləşmələr
+	vector<vector<int>> _byCell;    // Hüceyrə -> onu örtən yerləşmələr
+	int _maskWords;                 // Hər maskada 64-bitlik söz sayı
+	vector<uint64_t> _cellMasks;    // Yerləşmə maskaları, ardıcıl
+	vector<uint64_t> _haloMasks;
+
+	void addPlacement(int x, int y, int length, bool horizontal) {
+		int p = static_cast<int>(_length.size());
+		_startX.push_back(x);
+		_startY.push_back(y);
+		_length.push_back(length);
+		_horizontal.push_back(horizontal);
+		_cellFirst.push_back(static_cast<int>(_cells.size()));
+		_haloFirst.push_back(static_cast<int>(_halo.size()));
+
+		for (int i = 0; i < length; ++i) {
+			int cell = (y + (horizontal ? 0 : i)) * _size + x + (horizontal ? i : 0);
+			_cells.push_back(cell);
+			_byCell[cell].push_back(p);
+		}
+
+		int endX = x + (horizontal ? length - 1 : 0);
+		int endY = y + (horizontal ? 0 : length - 1);
+		for (int hy = max(y - 1, 0); hy <= min(endY + 1, _size - 1); ++hy) {
+			for (int hx = max(x - 1, 0); hx <= min(endX + 1, _size - 1); ++hx) {
+				_halo.push_back(hy * _size + hx);
+			}
+		}
+		_haloCount.push_back(static_cast<int>(_halo.size()) - _haloFirst[p]);
+		_byLength[length].push_back(p);
+
+		_cellMasks.resize(_cellMasks.size() + _maskWords, 0);
+		_haloMasks.resize(_haloMasks.size() + _maskWords, 0);
+		uint64_t* cellMask = &_cellMasks[p * _maskWords];
+		uint64_t* haloMask = &_haloMasks[p * _maskWords];
+		for (int i = 0; i < length; ++i) {
+			int cell = _cells[_cellFirst[p] + i];
+			cellMask[cell >> 6] |= 1ULL << (cell & 63);
+		}
+		for (int i = 0; i < _haloCount[p]; ++i) {
+			int cell = _halo[_haloFirst[p] + i];
+			haloMask[cell >> 6] |= 1ULL << (cell & 63);
+		}
+	}
+
+public:
+	PlacementTable(int size, int longest)
+		: _size(size), _longest(longest), _maskWords((size * size + 63) / 64) {
+		_byLength.resize(longest + 1);
+		_byCell.resize(size * size);
+		for (int length = 1; length <= longest; ++length) {
+			forEachPlacement(size, length, [this, length](int x, int y, bool horizontal) {
+				addPlacement(x, y, length, horizontal);
+			});
+		}
+	}
+
+	int getBoardSize() const { return _size; }
+	int getLongest() const { return _longest; }
+	int count() const { return static_cast<int>(_length.size()); }
+
+	int getLength(int p) const { return _length[p]; }
+	Point getStart(int p) const { return Point(_startX[p], _startY[p]); }
+	bool isHorizontal(int p) const { return _horizontal[p] != 0; }
+	const int* cells(int p) const { return &_cells[_cellFirst[p]]; }
+
+	const vector<int>& withLength(int length) const { return _byLength[length]; }
+	const vector<int>& covering(int cell) const { return _byCell[cell]; }
+
+	const uint64_t* cellMask(int p) const { return &_cellMasks[p * _maskWords]; }
+	const uint64_t* haloMask(int p) const { return &_haloMasks[p * _maskWords]; }
+
+	// No cell of the placement is blocked
+	bool isFree(int p, const BitBoard& blocked) const {
+		const uint64_t* mask = cellMask(p);
+		const uint64_t* words = blocked.words();
+		if (_maskWords == 2) return !((mask[0] & words[0]) | (mask[1] & words[1]));
+		for (int w = 0; w < _maskWords; ++w) {
+			if (mask[w] & words[w]) return false;
+		}
+		return true;
+	}
+
+	// Block the placement's cells and halo for later ships
+	void occupy(int p, BitBoard& blocked) const {
+		const uint64_t* mask = haloMask(p);
+		uint64_t* words = blocked.words();
+		for (int w = 0; w < _maskWords; ++w) words[w] |= mask[w];
+	}
+
+	static shared_ptr<const PlacementTable> get(int size, int longest) {
+		static mutex cacheMutex;
+		static map<pair<int, int>, shared_ptr<const PlacementTable>> cache;
+
+		lock_guard<mutex> lock(cacheMutex);
+		auto& entry = cache[make_pair(size, longest)];
+		if (!entry) entry = make_shared<const PlacementTable>(size, longest);
+		return entry;
+	}
+};
@@ -6,10 +6,68 @@ class Player {
 protected:
 	Board board;
 	vector<vector<char>> _attackBoard;
+	EventRing* _events;
+	int _seat;
+	Rng _rng;
 
+	// What this player knows and its random stream - everything but the
+	// board. Subclasses with state of their own add it after this.
+	virtual void saveKnowledge(BinaryWriter& out) const {
+		for (int i = 0; i < 4; ++i) out.writeU64(_rng.getState(i));
+		for (const auto& row : _attackBoard) {
+			out.writeBytes(reinterpret_cast<const uint8_t*>(row.data()), row.size());
+		}
+	}
+
+	virtual void loadKnowledge(BinaryReader& in) {
+		for (int i = 0; i < 4; ++i) _rng.setState(i, in.readU64());
+		for (auto& row : _attackBoard) {
+			const uint8_t* bytes = in.current();
+			in.skip(row.size());
+			for (size_t i = 0; i < row.size(); ++i) {
+				char mark = static_cast<char>(bytes[i]);
+				if (mark != '#' && mark != 'H' && mark != 'M' && mark != '.') throw runtime_error("Corrupt attack board in saved game");
+				row[i] = mark;
+			}
+		}
+	}
+
+	// A cell the no-touch rule says is empty. Subclasses that track more
+	// than the attack board add the cell to their own state as well.
+	virtual void excludeCell(int x, int y) {
+		_attackBoard[y][x] = '.';
+	}
+
+	// Ships never touch, not even at a corner, so every cell around a sunk
+	// ship is empty. The ship is the line of hits through p - it cannot
+	// run into another ship's hits, which are a cell away at least.
+	void excludeHalo(const Point& p, int length) {
+		int size = board.getBoardSize();
+		int x = p.getX(), y = p.getY();
+		bool horizontal = (x > 0 && _attackBoard[y][x - 1] == 'H') || (x + 1 < size && _attackBoard[y][x + 1] == 'H');
+		int dx = horizontal ? 1 : 0, dy = horizontal ? 0 : 1;
+
+		int fromX = x, fromY = y, toX = x, toY = y;
+		for (int i = 1; i < length; ++i) {
+			if (fromX - dx >= 0 && fromY - dy >= 0 && _attackBoard[fromY - dy][fromX - dx] == 'H') {
+				fromX -= dx;
+				fromY -= dy;
+			}
+			else if (toX + dx < size && toY + dy < size && _attackBoard[toY + dy][toX + dx] == 'H') {
+				toX += dx;
+				toY += dy;
+			}
+		}
+
+		for (int row = max(fromY - 1, 0); row <= min(toY + 1, size - 1); ++row) {
+			for (int col = max(fromX - 1, 0); col <= min(toX + 1, size - 1); ++col) {
+				if (_attackBoard[row][col] == '#') excludeCell(col, row);
+			}
+		}
+	}
 
 public:
-	Player(Board& b) : board(b) {
+	Player(Board& b, Rng rng = Rng()) : board(b), _events(nullptr), _seat(0), _rng(rng) {
 		_attackBoard.resize(board.getBoardSize(),
 			vector<char>(board.getBoardSize(), '#'));
 	}
@@ -18,16 +76,23 @@ public:
 	virtual Point selectAttack() {
 		// Random attack for base implementation
 		int size = board.getBoardSize();
-		return Point(rand() % size, rand() % size);
+		return Point(_rng.nextInt(size), _rng.nextInt(size));
 	}
-	virtual void takeTurn() = 0;
-	virtual void processAttackResult(const Point& p, bool hit) {
-		// Update attack board
-		if (p.getX() >= 0 && p.getX() < board.getBoardSize() &&
-			p.getY() >= 0 && p.getY() < board.getBoardSize()) {
-			_attackBoard[p.getY()][p.getX()] = hit ? 'H' : 'M';
+	// Salvo rules: the next count shots, all fired before any result comes back
+	virtual void selectAttacks(int count, vector<Point>& shots) {
+		shots.clear();
+		for (int i = 0; i < count; ++i) {
+			shots.push_back(selectAttack());
 		}
 	}
+	virtual void takeTurn() = 0;
+	// Attack board: 'H' hit, 'M' miss, '.' empty by the no-touch rule, '#' unknown
+	virtual void processAttackResult(const Point& p, const AttackResult& result) {
+		// A rejected shot was off the board or already on it - nothing new
+		if (result.outcome == AttackOutcome::Rejected || !board.isValid(p)) return;
+		_attackBoard[p.getY()][p.getX()] = result.isHit() ? 'H' : 'M';
+		if (result.isSunk()) excludeHalo(p, result.length);
+	}
 	virtual void reset() {
 		// Reset the main board
 		board.reset();
@@ -40,6 +105,47 @@ public:
 
 	virtual ~Player() = default;
 
+	// Save/resume of a game in progress: the board, then saveKnowledge()
+	virtual void saveState(BinaryWriter& out) const {
+		board.write(out);
+		saveKnowledge(out);
+	}
+
+	virtual void loadState(BinaryReader& in) {
+		board.read(in);
+		loadKnowledge(in);
+	}
+
+	// A loaded attack board must match the shots on the board it was aimed
+	// at: 'H' and 'M' exactly where those are, '.' only on untouched water
+	void checkKnowledge(const Board& opponent) const {
+		int size = board.getBoardSize();
+		if (opponent.getBoardSize() != size) throw runtime_error("Saved boards are different sizes");
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				char mark = _attackBoard[y][x];
+				char cell = opponent.getCell(x, y);
+				bool shot = cell == 'H' || cell == 'M';
+				if (shot ? mark != cell : (mark == 'H' || mark == 'M' || (mark == '.' && cell == 'S'))) {
+					throw runtime_error("Corrupt attack board in saved game");
+				}
+			}
+		}
+	}
+
+	// Same seed, same choices - lets a game be replayed exactly
+	void reseed(uint64_t seed) {
+		_rng.reseed(seed);
+	}
+
+	// Where this player and its board report what happens; players start
+	// with none, which is what headless runs want
+	void setEvents(EventRing* events, int seat) {
+		_events = events;
+		_seat = seat;
+		board.setEvents(events, seat);
+	}
+
 	Board& getBoard() { return board; }
 	const vector<vector<char>>& getAttackBoard() const { return _attackBoard; }
 	vector<vector<char>>& getAttackBoard() { return _attackBoard; }
@@ -0,0 +1,27 @@
+#pragma once
+
+// Generated by tools/priorGen.cpp (make prior) - do not edit by hand.
+// Standard fleet on the standard board, 2000000 weighted layouts.
+
+const int PRIOR_BOARD_SIZE = 10;
+
+// Chance that each cell holds a ship before any shot, row-major
+constexpr float PRIOR_OCCUPANCY[100] = {
+	0.23634f, 0.22511f, 0.25672f, 0.25166f, 0.24745f, 0.24745f, 0.25166f, 0.25672f, 0.22511f, 0.23634f,
+	0.22511f, 0.14770f, 0.16765f, 0.15472f, 0.15457f, 0.15457f, 0.15472f, 0.16765f, 0.14770f, 0.22511f,
+	0.25672f, 0.16765f, 0.20403f, 0.19274f, 0.19480f, 0.19480f, 0.19274f, 0.20403f, 0.16765f, 0.25672f,
+	0.25166f, 0.15472f, 0.19274f, 0.17800f, 0.18028f, 0.18028f, 0.17800f, 0.19274f, 0.15472f, 0.25166f,
+	0.24745f, 0.15457f, 0.19480f, 0.18028f, 0.18248f, 0.18248f, 0.18028f, 0.19480f, 0.15457f, 0.24745f,
+	0.24745f, 0.15457f, 0.19480f, 0.18028f, 0.18248f, 0.18248f, 0.18028f, 0.19480f, 0.15457f, 0.24745f,
+	0.25166f, 0.15472f, 0.19274f, 0.17800f, 0.18028f, 0.18028f, 0.17800f, 0.19274f, 0.15472f, 0.25166f,
+	0.25672f, 0.16765f, 0.20403f, 0.19274f, 0.19480f, 0.19480f, 0.19274f, 0.20403f, 0.16765f, 0.25672f,
+	0.22511f, 0.14770f, 0.16765f, 0.15472f, 0.15457f, 0.15457f, 0.15472f, 0.16765f, 0.14770f, 0.22511f,
+	0.23634f, 0.22511f, 0.25672f, 0.25166f, 0.24745f, 0.24745f, 0.25166f, 0.25672f, 0.22511f, 0.23634f
+};
+
+// Shots to open with while nothing is hit: each is the likeliest ship
+// cell given that all shots before it missed
+const int PRIOR_OPENING_LENGTH = 16;
+constexpr unsigned char PRIOR_OPENING[PRIOR_OPENING_LENGTH] = {
+	2, 97, 29, 70, 6, 30, 69, 93, 17, 8, 21, 10, 38, 49, 58, 47
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+
+// Baseline opponent: a random legal fleet and random shots from
+// Player::selectAttack, which may even repeat a cell.
+class RandomPlayer final : public Player {
+private:
+	FleetSampler _sampler;
+	vector<int> _placements;
+
+public:
+	RandomPlayer(Board& board, Rng rng = Rng(), const vector<int>& fleet = StandardFleet::lengths())
+		: Player(board, rng), _sampler(board.getBoardSize(), fleet) {
+	}
+
+	void placeShips(bool autoPlace = false) override {
+		if (!_sampler.placeFleet(board, _rng, _placements)) {
+			EventRing::emit(_events, GameEventType::PlacementFailed, _seat);
+			throw runtime_error("Could not place the fleet");
+		}
+		EventRing::emit(_events, GameEventType::FleetPlaced, _seat);
+	}
+
+	void takeTurn() override {
+	}
+};
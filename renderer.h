@@ -0,0 +1,165 @@
+#pragma once
+
+
+// Double-buffered console renderer. A frame is drawn into an in-memory
+// buffer of (character, colour) cells, compared with the frame already on
+// screen, and only the cells that changed are sent - as one batched string
+// of ANSI escapes written with a single call. Colours use the same
+// attribute numbers as SetConsoleTextAttribute (7 grey, 10 green, ...).
+class ConsoleRenderer {
+private:
+	struct ScreenCell {
+		char ch;
+		unsigned char color;
+
+		bool operator==(const ScreenCell& other) const {
+			return ch == other.ch && color == other.color;
+		}
+		bool operator!=(const ScreenCell& other) const {
+			return !(*this == other);
+		}
+	};
+
+	static const int DEFAULT_COLOR = 7;
+
+	int _width;
+	int _height;
+	int _usedRows;          // Cari kadrda istifadə olunan sətirlər
+	int _frontRows;         // Ekrandakı kadrın sətirləri
+	vector<ScreenCell> _front;
+	vector<ScreenCell> _back;
+	bool _fullRedraw;
+	string _out;
+	chrono::steady_clock::time_point _frameStart;   // Yalnız metrika açıq olanda
+
+	void moveTo(int x, int y) {
+		_out += "\033[";
+		_out += to_string(y + 1);
+		_out += ';';
+		_out += to_string(x + 1);
+		_out += 'H';
+	}
+
+	void write(const string& data) {
+		fwrite(data.data(), 1, data.size(), stdout);
+		fflush(stdout);
+	}
+
+public:
+	ConsoleRenderer(int width = 120, int height = 40)
+		: _width(width), _height(height), _usedRows(0), _frontRows(0),
+		_front(width * height, ScreenCell{ ' ', DEFAULT_COLOR }),
+		_back(width * height, ScreenCell{ ' ', DEFAULT_COLOR }),
+		_fullRedraw(true) {
+		_out.reserve(width * height * 4);
+#ifdef _WIN32
+		// ANSI escapes need virtual terminal processing on the Windows console
+		HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+		DWORD mode = 0;
+		if (GetConsoleMode(console, &mode)) {
+			SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+		}
+#endif
+	}
+
+	static ConsoleRenderer& shared() {
+		static ConsoleRenderer renderer;
+		return renderer;
+	}
+
+	// Console attribute (SetConsoleTextAttribute) -> ANSI foreground colour
+	static string ansiColor(int attribute) {
+		int fg = attribute & 0x0F;
+		if (fg == DEFAULT_COLOR) return "\033[0m";
+		int code = ((fg & 8) ? 90 : 30) + ((fg & 4) ? 1 : 0) + ((fg & 2) ? 2 : 0) + ((fg & 1) ? 4 : 0);
+		return "\033[0;" + to_string(code) + "m";
+	}
+
+	// Something else wrote to the screen - next present() repaints everything
+	void invalidate() {
+		_fullRedraw = true;
+	}
+
+	// Replaces system("cls"): clears with an escape instead of spawning a process
+	void clearScreen() {
+		write("\033[0m\033[2J\033[H");
+		invalidate();
+	}
+
+	void beginFrame() {
+		if (Metrics::enabled()) _frameStart = chrono::steady_clock::now();
+		fill(_back.begin(), _back.end(), ScreenCell{ ' ', DEFAULT_COLOR });
+		_usedRows = 0;
+	}
+
+	void put(int x, int y, char ch, int color = DEFAULT_COLOR) {
+		if (x < 0 || x >= _width || y < 0 || y >= _height) return;
+		_back[y * _width + x] = ScreenCell{ ch, static_cast<unsigned char>(color) };
+		_usedRows = max(_usedRows, y + 1);
+	}
+
+	// Returns the column after the text
+	int text(int x, int y, const string& s, int color = DEFAULT_COLOR) {
+		for (char ch : s) {
+			put(x++, y, ch, color);
+		}
+		_usedRows = max(_usedRows, y + 1);
+		return x;
+	}
+
+	// Right-aligned number in a field, like cout << setw(width) << value
+	int number(int x, int y, int value, int width, int color = DEFAULT_COLOR) {
+		string s = to_string(value);
+		if (static_cast<int>(s.size()) < width) s.insert(0, width - s.size(), ' ');
+		return text(x, y, s, color);
+	}
+
+	int getUsedRows() const {
+		return _usedRows;
+	}
+
+	// Sends the changed cells and leaves the cursor on the line under the frame
+	void present() {
+		_out.clear();
+		_out += "\033[?25l";
+		if (_fullRedraw) {
+			_out += "\033[0m\033[2J";
+			fill(_front.begin(), _front.end(), ScreenCell{ ' ', DEFAULT_COLOR });
+			_frontRows = 0;
+		}
+
+		int rows = max(_usedRows, _frontRows);
+		int currentColor = -1;
+		int cursorX = -1, cursorY = -1;
+
+		for (int y = 0; y < rows; ++y) {
+			for (int x = 0; x < _width; ++x) {
+				const ScreenCell& cell = _back[y * _width + x];
+				if (cell == _front[y * _width + x]) continue;
+
+				if (cursorX != x || cursorY != y) moveTo(x, y);
+				if (cell.color != currentColor) {
+					_out += ansiColor(cell.color);
+					currentColor = cell.color;
+				}
+				_out += cell.ch;
+				cursorX = x + 1;
+				cursorY = y;
+			}
+		}
+
+		// Kadrın altındakı köhnə mesajları sil
+		moveTo(0, _usedRows);
+		_out += "\033[0m\033[J\033[?25h";
+		write(_out);
+
+		_front.swap(_back);
+		_frontRows = _usedRows;
+		_fullRedraw = false;
+
+		if (Metrics::enabled()) {
+			Metrics::record(Histogram::RenderFrame, chrono::steady_clock::now() - _frameStart);
+			Metrics::frameShown();
+		}
+	}
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+
+// xoshiro256** generator. Small, fast and copyable, so every player, game
+// and worker thread can own its own stream instead of sharing rand().
+// Satisfies UniformRandomBitGenerator, so it also works with shuffle().
+class Rng {
+private:
+	uint64_t _s[4];
+
+	static uint64_t rotl(uint64_t x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+public:
+	typedef uint64_t result_type;
+
+	// Seeded from the clock and random_device - for interactive games
+	Rng() {
+		random_device device;
+		uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+			static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+		reseed(seed);
+	}
+
+	explicit Rng(uint64_t seed) {
+		reseed(seed);
+	}
+
+	// splitmix64 step - expands one 64-bit seed into well-mixed values
+	static uint64_t splitMix(uint64_t& state) {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// Independent child seed, e.g. per game index or per player
+	static uint64_t derive(uint64_t seed, uint64_t index) {
+		uint64_t state = seed ^ (index * 0xD1B54A32D192ED03ULL);
+		splitMix(state);
+		return splitMix(state);
+	}
+
+	void reseed(uint64_t seed) {
+		uint64_t state = seed;
+		for (int i = 0; i < 4; ++i) _s[i] = splitMix(state);
+	}
+
+	uint64_t next() {
+		uint64_t result = rotl(_s[1] * 5, 7) * 9;
+		uint64_t t = _s[1] << 17;
+		_s[2] ^= _s[0];
+		_s[3] ^= _s[1];
+		_s[1] ^= _s[2];
+		_s[0] ^= _s[3];
+		_s[2] ^= t;
+		_s[3] = rotl(_s[3], 45);
+		return result;
+	}
+
+	// Uniform in [0, bound) using the multiply-shift reduction
+	int nextInt(int bound) {
+		return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(bound)) >> 32);
+	}
+
+	// Uniform in [0, 1) from the top 53 bits
+	double nextDouble() {
+		return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	bool nextBool() {
+		return (next() >> 63) != 0;
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~0ULL; }
+	result_type operator()() { return next(); }
+
+	uint64_t getState(int i) const { return _s[i]; }
+	void setState(int i, uint64_t value) { _s[i] = value; }
+};
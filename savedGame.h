@@ -0,0 +1,83 @@
+#pragma once
+
+
+// File format for a game in progress: a header with the game's settings
+// and whose turn it is, then Player::saveState() of both players. Files
+// from another version are refused rather than half-loaded.
+struct SavedGame {
+	static const uint32_t MAGIC = 0x56534253; // "BSSV"
+	static const uint8_t VERSION = 2;
+
+	int mode = 0;           // Oyun menyusundakı sıra: 0 - PvP, 1 - PvC, 2 - CvC
+	int difficulty = 1;     // Difficulty dəyəri
+	bool salvo = false;
+	int shooter = 0;        // Növbəti atəşi açan oyunçu
+	uint64_t seed = 0;
+
+	void writeHeader(BinaryWriter& out) const {
+		out.writeU32(MAGIC);
+		out.writeU8(VERSION);
+		out.writeU8(static_cast<uint8_t>(mode));
+		out.writeU8(static_cast<uint8_t>(difficulty));
+		out.writeU8(salvo ? 1 : 0);
+		out.writeU8(static_cast<uint8_t>(shooter));
+		out.writeU64(seed);
+	}
+
+	void readHeader(BinaryReader& in) {
+		if (in.readU32() != MAGIC) throw runtime_error("Not a saved game");
+		if (in.readU8() != VERSION) throw runtime_error("Unsupported saved game version");
+		mode = in.readU8();
+		difficulty = in.readU8();
+		salvo = in.readU8() != 0;
+		shooter = in.readU8();
+		seed = in.readU64();
+		if (mode > 2 || difficulty > 2 || shooter > 1) throw runtime_error("Corrupt saved game header");
+	}
+
+	// Written to a temporary file and renamed over the old save, so a
+	// crash in the middle never leaves a torn file behind
+	static void writeFile(const string& path, const vector<uint8_t>& data) {
+		string temporary = path + ".tmp";
+		{
+			ofstream out(temporary, ios::binary | ios::trunc);
+			if (!out) throw runtime_error("Cannot open " + temporary);
+			out.write(reinterpret_cast<const char*>(data.data()), data.size());
+			if (!out) throw runtime_error("Failed to write " + temporary);
+		}
+#ifdef _WIN32
+		remove(path.c_str()); // Windows-da rename mövcud faylın üstünə yazmır
+#endif
+		if (rename(temporary.c_str(), path.c_str()) != 0) throw runtime_error("Cannot replace " + path);
+	}
+
+	static vector<uint8_t> readFile(const string& path) {
+		ifstream in(path, ios::binary);
+		if (!in) throw runtime_error("Cannot open " + path);
+		return vector<uint8_t>((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	}
+};
+
+
+// Writes saves on a background thread, one at a time, so whoever saves
+// only pays for encoding the snapshot - a few microseconds - and never for
+// the disk. A failed write is thrown by the next write() or by finish().
+class SaveWriter {
+private:
+	future<void> _pending;
+
+public:
+	~SaveWriter() {
+		if (_pending.valid()) _pending.wait();
+	}
+
+	void write(const string& path, vector<uint8_t> data) {
+		finish();
+		_pending = async(launch::async, [path, data = move(data)] { SavedGame::writeFile(path, data); });
+	}
+
+	// Waits for the last write
+	void finish() {
+		if (_pending.valid()) _pending.get();
+	}
+};
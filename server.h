@@ -0,0 +1,704 @@
+#pragma once
+
+#ifdef __linux__
+
+// Line protocol, one command per line, every reply ends with an "OK ..."
+// or "ERR ..." line:
+//   NEW [strategy] [seed]   new game against a server AI      -> OK <size> <fleet>
+//   PLACE x y H|V           place the next ship of the fleet  -> OK <length>
+//   AUTO                    place the whole fleet at random   -> OK
+//   FIRE x y                HIT|MISS x y or SUNK x y <length>, WIN when it was
+//                           the last ship; after a miss the AI's shots follow
+//                           as the same lines prefixed with ENEMY, and LOSE
+//   BOARD                   ROW <own> <enemy> per row
+//   BOT a b [seed]          AI vs AI game                     -> RESULT <winner> <shots> <total>
+//   METRICS                 process metrics in Prometheus text format
+//   QUIT
+class ServerSession {
+public:
+	enum class Outcome { Reply, RunOnWorker, Close };
+
+private:
+	enum class Job { None, AiTurn, BotGame };
+
+	// Player 0 is the server AI, player 1 only holds the client's fleet
+	SessionPool& _pool;
+	SessionPool::Lease _game;
+	vector<int> _fleet;
+	size_t _nextShip;
+	Rng _rng;
+	bool _over;
+
+	Job _job;
+	string _botFirst, _botSecond;
+	uint64_t _botSeed;
+
+	Player& ai() { return _game->getPlayer(0); }
+	Board& client() { return _game->getPlayer(1).getBoard(); }
+
+	static string cellText(int x, int y) {
+		return to_string(x) + " " + to_string(y);
+	}
+
+	// MISS, HIT, or SUNK with the ship's length if the shot finished it
+	static string resultText(const AttackResult& result, int x, int y) {
+		if (result.isSunk()) return "SUNK " + cellText(x, y) + " " + to_string(result.length);
+		return (result.isHit() ? "HIT " : "MISS ") + cellText(x, y);
+	}
+
+	bool readCell(const vector<string>& words, size_t at, int& x, int& y) const {
+		if (words.size() < at + 2) return false;
+		char* end = nullptr;
+		x = static_cast<int>(strtol(words[at].c_str(), &end, 10));
+		if (*end != '\0') return false;
+		y = static_cast<int>(strtol(words[at + 1].c_str(), &end, 10));
+		if (*end != '\0') return false;
+		int size = _pool.getBoardSize();
+		return x >= 0 && x < size && y >= 0 && y < size;
+	}
+
+	bool fleetPlaced() const {
+		return _nextShip == _fleet.size();
+	}
+
+	void aiTurn(string& out) {
+		Board& board = client();
+		const int maxShots = 4 * board.getBoardSize() * board.getBoardSize();
+		for (int shot = 0; shot < maxShots; ++shot) {
+			Point p = ai().selectAttack();
+			AttackResult result = board.attack(p);
+			ai().processAttackResult(p, result);
+
+			out += "ENEMY " + resultText(result, p.getX(), p.getY()) + "\n";
+			if (!result.isHit()) return;
+			if (board.allShipsSunk()) {
+				_over = true;
+				Metrics::count(Counter::GamesPlayed);
+				out += "LOSE\n";
+				return;
+			}
+		}
+	}
+
+	void botGame(string& out) {
+		SessionPool::Lease game = _pool.acquire(_botFirst, _botSecond);
+		game->reset(_botSeed);
+		game->getPlayer(0).placeShips(true);
+		game->getPlayer(1).placeShips(true);
+
+		GameResult result = Simulation::playGame(game->getPlayer(0), game->getPlayer(1), _pool.getBoardSize());
+		out += "RESULT " + to_string(result.winner + 1) + " " + to_string(result.shots) + " " + to_string(result.totalShots) + "\n";
+	}
+
+	Outcome newGame(const vector<string>& words, string& out) {
+		string strategy = words.size() > 1 ? words[1] : "hunt";
+		uint64_t seed = words.size() > 2 ? strtoull(words[2].c_str(), nullptr, 10) : _rng.next();
+
+		_game = SessionPool::Lease();  // Köhnə sessiya əvvəlcə hovuza qayıtsın
+		_game = _pool.acquire(strategy, REMOTE_KIND);
+		_game->reset(seed);
+		ai().placeShips(true);
+		_nextShip = 0;
+		_over = false;
+
+		out += "OK " + to_string(_pool.getBoardSize()) + " ";
+		for (size_t i = 0; i < _fleet.size(); ++i) {
+			out += (i ? "," : "") + to_string(_fleet[i]);
+		}
+		out += "\n";
+		return Outcome::Reply;
+	}
+
+	Outcome place(const vector<string>& words, string& out) {
+		int x, y;
+		if (!_game) out += "ERR no game\n";
+		else if (fleetPlaced()) out += "ERR fleet already placed\n";
+		else if (words.size() != 4 || !readCell(words, 1, x, y) || (words[3] != "H" && words[3] != "V")) out += "ERR usage: PLACE x y H|V\n";
+		else if (!client().placeShip(Point(x, y), _fleet[_nextShip], words[3] == "H")) out += "ERR cannot place here\n";
+		else out += "OK " + to_string(_fleet[_nextShip++]) + "\n";
+		return Outcome::Reply;
+	}
+
+	Outcome autoPlace(string& out) {
+		if (!_game) {
+			out += "ERR no game\n";
+			return Outcome::Reply;
+		}
+		client().reset();
+		_nextShip = 0;
+		_game->getPlayer(1).placeShips(true); // Alınmasa atır, execute() ERR yazır
+		_nextShip = _fleet.size();
+		out += "OK\n";
+		return Outcome::Reply;
+	}
+
+	Outcome fire(const vector<string>& words, string& out) {
+		int x, y;
+		if (!_game) out += "ERR no game\n";
+		else if (!fleetPlaced()) out += "ERR place your fleet first\n";
+		else if (_over) out += "ERR game over\n";
+		else if (words.size() != 3 || !readCell(words, 1, x, y)) out += "ERR usage: FIRE x y\n";
+		else {
+			Board& target = ai().getBoard();
+			char cell = target.getCell(x, y);
+			if (cell == 'H' || cell == 'M') {
+				out += "ERR already attacked\n";
+				return Outcome::Reply;
+			}
+
+			AttackResult result = target.attack(Point(x, y));
+			out += resultText(result, x, y) + "\n";
+			if (!result.isHit()) {
+				_job = Job::AiTurn;
+				return Outcome::RunOnWorker;
+			}
+			if (target.allShipsSunk()) {
+				_over = true;
+				Metrics::count(Counter::GamesPlayed);
+				out += "WIN\n";
+			}
+			out += "OK\n";
+		}
+		return Outcome::Reply;
+	}
+
+	Outcome show(string& out) {
+		if (!_game) {
+			out += "ERR no game\n";
+			return Outcome::Reply;
+		}
+		const Board& own = client();
+		const Board& enemy = ai().getBoard();
+		for (int y = 0; y < own.getBoardSize(); ++y) {
+			string mine, attack;
+			for (int x = 0; x < own.getBoardSize(); ++x) {
+				mine += own.getCell(x, y);
+				char cell = enemy.getCell(x, y);
+				attack += cell == 'S' ? '#' : cell;   // Düşmən gəmiləri gizli qalır
+			}
+			out += "ROW " + mine + " " + attack + "\n";
+		}
+		out += "OK\n";
+		return Outcome::Reply;
+	}
+
+	Outcome bot(const vector<string>& words, string& out) {
+		if (words.size() < 3) {
+			out += "ERR usage: BOT a b [seed]\n";
+			return Outcome::Reply;
+		}
+		try {
+			StrategyRegistry::get(words[1]);
+			StrategyRegistry::get(words[2]);
+		}
+		catch (const invalid_argument& e) {
+			out += string("ERR ") + e.what() + "\n";
+			return Outcome::Reply;
+		}
+		_botFirst = words[1];
+		_botSecond = words[2];
+		_botSeed = words.size() > 3 ? strtoull(words[3].c_str(), nullptr, 10) : _rng.next();
+		_job = Job::BotGame;
+		return Outcome::RunOnWorker;
+	}
+
+public:
+	// Player kind that stands in for the client in pooled sessions
+	static constexpr const char* REMOTE_KIND = "remote";
+
+	explicit ServerSession(SessionPool& pool)
+		: _pool(pool), _fleet(StandardFleet::lengths()),
+		_nextShip(0), _over(false), _job(Job::None), _botSeed(0) {
+	}
+
+	// Runs one command on the I/O thread. Anything slow (AI moves, bot games)
+	// is left for runOnWorker(), and the caller must not touch the session
+	// until that has finished.
+	Outcome execute(const string& line, string& out) {
+		vector<string> words;
+		istringstream parser(line);
+		for (string word; parser >> word;) words.push_back(word);
+		if (words.empty()) return Outcome::Reply;
+
+		string command = words[0];
+		transform(command.begin(), command.end(), command.begin(), ::toupper);
+		try {
+			if (command == "NEW") return newGame(words, out);
+			if (command == "PLACE") return place(words, out);
+			if (command == "AUTO") return autoPlace(out);
+			if (command == "FIRE") return fire(words, out);
+			if (command == "BOARD") return show(out);
+			if (command == "BOT") return bot(words, out);
+			if (command == "METRICS") {
+				ostringstream text;
+				Metrics::snapshot().writePrometheus(text);
+				out += text.str() + "OK\n";
+				return Outcome::Reply;
+			}
+			if (command == "QUIT") {
+				out += "OK bye\n";
+				return Outcome::Close;
+			}
+		}
+		catch (const exception& e) {
+			out += string("ERR ") + e.what() + "\n";
+			return Outcome::Reply;
+		}
+		out += "ERR unknown command\n";
+		return Outcome::Reply;
+	}
+
+	void runOnWorker(string& out) {
+		Job job = _job;
+		_job = Job::None;
+		try {
+			if (job == Job::AiTurn) aiTurn(out);
+			else if (job == Job::BotGame) botGame(out);
+		}
+		catch (const exception& e) {
+			out += string("ERR ") + e.what() + "\n";
+			return;
+		}
+		out += "OK\n";
+	}
+};
+
+
+// Hosts many ServerSessions, one per connection, behind a Unix domain
+// socket. A single thread runs the epoll loop and all socket I/O; AI
+// moves go to a worker pool and come back through an eventfd, so a slow
+// search never stalls other connections.
+class GameServer {
+private:
+	static const size_t MAX_LINE = 1024;
+
+	struct Connection {
+		int fd;
+		ServerSession session;
+		string input;
+		string output;
+		string workerOutput;    // İşçi thread yazır, bitəndən sonra I/O thread oxuyur
+		bool busy;              // Sessiya işçidədir
+		bool closing;           // Cavab göndəriləndən sonra bağla
+		bool closed;
+		bool writing;           // EPOLLOUT qeydiyyatdadır
+		bool inputEnded;        // Klient yazmağı bitirib (recv 0 qaytardı)
+
+		Connection(int socket, SessionPool& pool)
+			: fd(socket), session(pool), busy(false), closing(false), closed(false), writing(false), inputEnded(false) {
+		}
+	};
+
+	string _path;
+	int _listenFd;
+	int _epollFd;
+	int _wakeFd;
+	SessionPool _sessions;      // Bağlantılardan və işçilərdən əvvəl yaranır, sonra yox olur
+	ThreadPool _workers;        // Joined first: a finished job's copy of its connection can hold the last lease
+	map<int, shared_ptr<Connection>> _connections;
+
+	mutex _doneMutex;
+	vector<shared_ptr<Connection>> _done;
+	size_t _inFlight;           // İşçiyə verilib, hələ toplanmayıb
+	atomic<bool> _stopping;
+
+	static void setNonBlocking(int fd) {
+		fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+	}
+
+	static runtime_error systemError(const string& what) {
+		return runtime_error(what + ": " + strerror(errno));
+	}
+
+	void watch(Connection& c) {
+		epoll_event event = {};
+		event.events = (c.inputEnded ? 0 : EPOLLIN | EPOLLRDHUP) | (c.writing ? EPOLLOUT : 0);
+		event.data.fd = c.fd;
+		epoll_ctl(_epollFd, EPOLL_CTL_MOD, c.fd, &event);
+	}
+
+	void accept() {
+		while (true) {
+			int fd = ::accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+			if (fd < 0) {
+				if (errno == EINTR) continue;
+				return; // EAGAIN, ya da fd limiti - növbəti hadisədə yenidən
+			}
+			epoll_event event = {};
+			event.events = EPOLLIN | EPOLLRDHUP;
+			event.data.fd = fd;
+			if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+				::close(fd);
+				continue;
+			}
+			_connections[fd] = make_shared<Connection>(fd, _sessions);
+		}
+	}
+
+	void close(shared_ptr<Connection> c) {
+		if (c->closed) return;
+		c->closed = true;
+		epoll_ctl(_epollFd, EPOLL_CTL_DEL, c->fd, nullptr);
+		::close(c->fd);
+		_connections.erase(c->fd);
+	}
+
+	void flush(const shared_ptr<Connection>& c) {
+		while (!c->output.empty()) {
+			ssize_t sent = ::send(c->fd, c->output.data(), c->output.size(), MSG_NOSIGNAL);
+			if (sent < 0) {
+				if (errno == EINTR) continue;
+				if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+				close(c);
+				return;
+			}
+			c->output.erase(0, static_cast<size_t>(sent));
+		}
+
+		if (c->output.empty() && c->closing) {
+			close(c);
+			return;
+		}
+		bool writing = !c->output.empty();
+		if (writing != c->writing) {
+			c->writing = writing;
+			watch(*c);
+		}
+	}
+
+	// Runs complete lines until one has to wait for a worker. Once the
+	// client has stopped sending, the connection closes after the last
+	// line's reply is out.
+	void process(const shared_ptr<Connection>& c) {
+		while (!c->busy && !c->closing) {
+			size_t end = c->input.find('\n');
+			if (end == string::npos) {
+				if (c->input.size() > MAX_LINE) {
+					c->output += "ERR line too long\n";
+					c->closing = true;
+				}
+				break;
+			}
+			string line = c->input.substr(0, end);
+			c->input.erase(0, end + 1);
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+
+			ServerSession::Outcome outcome = c->session.execute(line, c->output);
+			if (outcome == ServerSession::Outcome::Close) c->closing = true;
+			else if (outcome == ServerSession::Outcome::RunOnWorker) submit(c);
+		}
+		if (c->inputEnded && !c->busy) c->closing = true;
+		flush(c);
+	}
+
+	void submit(const shared_ptr<Connection>& c) {
+		c->busy = true;
+		c->workerOutput.clear();
+		_inFlight++;
+		_workers.submit([this, c] {
+			c->session.runOnWorker(c->workerOutput);
+
+			// Under the lock, so once the destructor has seen every job done no worker touches _wakeFd
+			lock_guard<mutex> lock(_doneMutex);
+			_done.push_back(c);
+			uint64_t one = 1;
+			ssize_t ignored = ::write(_wakeFd, &one, sizeof(one));
+			(void)ignored;
+		});
+	}
+
+	void read(const shared_ptr<Connection>& c) {
+		char buffer[4096];
+		while (true) {
+			ssize_t received = ::recv(c->fd, buffer, sizeof(buffer), 0);
+			if (received > 0) {
+				c->input.append(buffer, static_cast<size_t>(received));
+				continue;
+			}
+			if (received < 0 && errno == EINTR) continue;
+			if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+			if (received < 0) {
+				// Bağlantı qırıldı: işçidə olan sessiya bitəndə atılacaq
+				close(c);
+				return;
+			}
+
+			// Klient yazmağı bitirdi: son sətir də əmrdir, cavablar hələ göndərilir
+			c->inputEnded = true;
+			if (!c->input.empty() && c->input.back() != '\n') c->input += '\n';
+			watch(*c);
+			break;
+		}
+		process(c);
+	}
+
+	void collectFinished() {
+		uint64_t count;
+		ssize_t ignored = ::read(_wakeFd, &count, sizeof(count));
+		(void)ignored;
+
+		vector<shared_ptr<Connection>> done;
+		{
+			lock_guard<mutex> lock(_doneMutex);
+			done.swap(_done);
+		}
+		_inFlight -= done.size();
+		for (auto& c : done) {
+			c->busy = false;
+			if (c->closed) continue;
+			c->output += c->workerOutput;
+			process(c);
+		}
+	}
+
+public:
+	GameServer(const string& path, int workers = 0)
+		: _path(path), _listenFd(-1), _epollFd(-1), _wakeFd(-1), _workers(workers), _inFlight(0), _stopping(false) {
+		// The client's fleet sits on a RandomPlayer's board, which also gives AUTO its placement
+		_sessions.addFactory(ServerSession::REMOTE_KIND, [](Board& board, chrono::microseconds) {
+			return unique_ptr<Player>(new RandomPlayer(board, Rng(0)));
+		});
+
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if (path.size() >= sizeof(address.sun_path)) throw invalid_argument("Socket path is too long: " + path);
+		strcpy(address.sun_path, path.c_str());
+
+		_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		if (_listenFd < 0) throw systemError("socket");
+		::unlink(path.c_str());   // Əvvəlki işdən qalmış socket faylı
+		if (::bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) throw systemError("bind " + path);
+		if (::listen(_listenFd, SOMAXCONN) < 0) throw systemError("listen");
+
+		_epollFd = epoll_create1(EPOLL_CLOEXEC);
+		_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (_epollFd < 0 || _wakeFd < 0) throw systemError("epoll");
+
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = _listenFd;
+		epoll_ctl(_epollFd, EPOLL_CTL_ADD, _listenFd, &event);
+		event.data.fd = _wakeFd;
+		epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event);
+	}
+
+	GameServer(const GameServer&) = delete;
+	GameServer& operator=(const GameServer&) = delete;
+
+	~GameServer() {
+		// İşçilər bitməlidir - onlar _wakeFd-yə yazır
+		while (true) {
+			{
+				lock_guard<mutex> lock(_doneMutex);
+				_inFlight -= _done.size();
+				_done.clear();
+			}
+			if (_inFlight == 0) break;
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+		for (auto& entry : _connections) ::close(entry.first);
+		if (_listenFd >= 0) {
+			::close(_listenFd);
+			::unlink(_path.c_str());
+		}
+		if (_epollFd >= 0) ::close(_epollFd);
+		if (_wakeFd >= 0) ::close(_wakeFd);
+	}
+
+	// Serves until stop()
+	void run() {
+		epoll_event events[256];
+		while (!_stopping.load()) {
+			int count = epoll_wait(_epollFd, events, 256, -1);
+			if (count < 0) {
+				if (errno == EINTR) continue;
+				throw systemError("epoll_wait");
+			}
+
+			for (int i = 0; i < count; ++i) {
+				int fd = events[i].data.fd;
+				if (fd == _listenFd) {
+					accept();
+					continue;
+				}
+				if (fd == _wakeFd) {
+					collectFinished();
+					continue;
+				}
+
+				auto found = _connections.find(fd);
+				if (found == _connections.end()) continue;
+				shared_ptr<Connection> c = found->second;
+				if (events[i].events & EPOLLOUT) flush(c);
+				if (!c->closed && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) read(c);
+			}
+		}
+	}
+
+	// Safe from any thread and from a signal handler
+	void stop() {
+		_stopping.store(true);
+		uint64_t one = 1;
+		ssize_t ignored = ::write(_wakeFd, &one, sizeof(one));
+		(void)ignored;
+	}
+
+	size_t getConnectionCount() const {
+		return _connections.size();
+	}
+};
+
+
+// Test client: opens many connections at once and plays every one of them
+// against the server, one command per connection in turn, so the server
+// really holds that many live sessions. Shots come from a local hunt AI.
+class GameClient {
+private:
+	struct Stream {
+		int fd;
+		string buffer;
+		ComputerPlayer shooter;
+		int gamesLeft;
+		bool placing;
+
+		Stream(int socket, Board& board, int games, uint64_t seed)
+			: fd(socket), shooter(board, AIStrategy::Hunt, Rng(seed)), gamesLeft(games), placing(true) {
+		}
+	};
+
+	string _path;
+
+	static bool sendLine(int fd, const string& line) {
+		string data = line + "\n";
+		size_t done = 0;
+		while (done < data.size()) {
+			ssize_t sent = ::send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+			if (sent < 0 && errno == EINTR) continue;
+			if (sent <= 0) return false;
+			done += static_cast<size_t>(sent);
+		}
+		return true;
+	}
+
+	// Lines of one reply, up to and including the OK/ERR line
+	static bool readReply(Stream& s, vector<string>& lines) {
+		lines.clear();
+		while (true) {
+			size_t end;
+			while ((end = s.buffer.find('\n')) != string::npos) {
+				string line = s.buffer.substr(0, end);
+				s.buffer.erase(0, end + 1);
+				lines.push_back(line);
+				if (line.compare(0, 2, "OK") == 0 || line.compare(0, 3, "ERR") == 0) return true;
+			}
+			char chunk[4096];
+			ssize_t received = ::recv(s.fd, chunk, sizeof(chunk), 0);
+			if (received < 0 && errno == EINTR) continue;
+			if (received <= 0) return false;
+			s.buffer.append(chunk, static_cast<size_t>(received));
+		}
+	}
+
+	int connectSocket() const {
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if (_path.size() >= sizeof(address.sun_path)) throw invalid_argument("Socket path is too long: " + _path);
+		strcpy(address.sun_path, _path.c_str());
+
+		int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (fd < 0) throw runtime_error(string("socket: ") + strerror(errno));
+		if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+			::close(fd);
+			throw runtime_error("connect " + _path + ": " + strerror(errno));
+		}
+		return fd;
+	}
+
+public:
+	struct Summary {
+		long long games = 0;
+		long long won = 0;
+		long long lost = 0;
+		long long commands = 0;
+		long long errors = 0;
+		double seconds = 0;
+	};
+
+	explicit GameClient(const string& path) : _path(path) {
+	}
+
+	Summary run(int connections, int gamesPerConnection, const string& strategy, uint64_t seed) {
+		Summary summary;
+		Board board(STANDARD_BOARD_SIZE);
+		vector<unique_ptr<Stream>> streams;
+		for (int i = 0; i < connections; ++i) {
+			streams.push_back(make_unique<Stream>(connectSocket(), board, gamesPerConnection, Rng::derive(seed, static_cast<uint64_t>(i))));
+		}
+
+		auto started = chrono::steady_clock::now();
+		vector<string> reply;
+		uint64_t gameSeed = seed;
+		bool active = true;
+		while (active) {
+			active = false;
+			for (auto& stream : streams) {
+				Stream& s = *stream;
+				if (s.gamesLeft == 0) continue;
+				active = true;
+
+				string command;
+				Point shot;
+				if (s.placing) {
+					command = "NEW " + strategy + " " + to_string(gameSeed++);
+				}
+				else {
+					shot = s.shooter.selectAttack();
+					command = "FIRE " + to_string(shot.getX()) + " " + to_string(shot.getY());
+				}
+
+				if (!sendLine(s.fd, command) || !readReply(s, reply)) throw runtime_error("Server closed the connection");
+				summary.commands++;
+				if (reply.back().compare(0, 3, "ERR") == 0) {
+					summary.errors++;
+					s.gamesLeft = 0;
+					continue;
+				}
+
+				if (s.placing) {
+					if (!sendLine(s.fd, "AUTO") || !readReply(s, reply)) throw runtime_error("Server closed the connection");
+					summary.commands++;
+					s.shooter.reset();
+					s.placing = false;
+					continue;
+				}
+
+				bool over = false;
+				for (const string& line : reply) {
+					if (line.compare(0, 4, "SUNK") == 0) {
+						// SUNK x y length - the server does not say which ship
+						short length = static_cast<short>(atoi(line.c_str() + line.rfind(' ') + 1));
+						s.shooter.processAttackResult(shot, AttackResult{ AttackOutcome::Sunk, -1, length });
+					}
+					else if (line.compare(0, 3, "HIT") == 0) s.shooter.processAttackResult(shot, AttackResult{ AttackOutcome::Hit });
+					else if (line.compare(0, 4, "MISS") == 0) s.shooter.processAttackResult(shot, AttackResult{ AttackOutcome::Miss });
+					else if (line == "WIN") summary.won++, over = true;
+					else if (line == "LOSE") summary.lost++, over = true;
+				}
+				if (over) {
+					summary.games++;
+					s.gamesLeft--;
+					s.placing = true;
+				}
+			}
+		}
+		summary.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+
+		for (auto& stream : streams) {
+			sendLine(stream->fd, "QUIT");
+			::close(stream->fd);
+		}
+		return summary;
+	}
+};
+
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+
+// The two players of a game, built once and reset in place between games.
+// Each player owns its board, so a reset clears everything a game touched
+// without a single allocation.
+class GameSession {
+private:
+	string _kinds[2];
+	unique_ptr<Player> _players[2];
+
+public:
+	GameSession(const string& first, const string& second, unique_ptr<Player> firstPlayer, unique_ptr<Player> secondPlayer)
+		: _kinds{ first, second } {
+		_players[0] = move(firstPlayer);
+		_players[1] = move(secondPlayer);
+	}
+
+	Player& getPlayer(int index) { return *_players[index]; }
+	const string& getKind(int index) const { return _kinds[index]; }
+
+	bool matches(const string& first, const string& second) const {
+		return _kinds[0] == first && _kinds[1] == second;
+	}
+
+	// Ready for a new game: both players reseeded from seed and reset
+	void reset(uint64_t seed) {
+		Simulation::seedGame(*_players[0], *_players[1], seed);
+		_players[0]->reset();
+		_players[1]->reset();
+	}
+};
+
+
+// Idle GameSessions waiting to be checked out again. A session is only
+// built when no idle one has the requested pair of players, so once the
+// pool is warm, starting a game costs two resets and no heap traffic.
+// Player kinds are StrategyRegistry names plus any added with addFactory().
+class SessionPool {
+private:
+	int _boardSize;
+	chrono::microseconds _budget;
+	map<string, StrategyFactory> _factories;
+
+	mutex _mutex;
+	vector<unique_ptr<GameSession>> _idle;
+	size_t _created;
+
+	unique_ptr<Player> build(const string& kind) {
+		Board board(_boardSize);
+		auto own = _factories.find(kind);
+		unique_ptr<Player> player = own != _factories.end() ? own->second(board, _budget) : StrategyRegistry::get(kind)(board, _budget);
+		return player;
+	}
+
+	unique_ptr<GameSession> create(const string& first, const string& second) {
+		unique_ptr<GameSession> session(new GameSession(first, second, build(first), build(second)));
+		lock_guard<mutex> lock(_mutex);
+		_created++;
+		_idle.reserve(_created);  // Qaytarılanda push_back yer ayırmasın
+		return session;
+	}
+
+	void release(unique_ptr<GameSession> session) {
+		lock_guard<mutex> lock(_mutex);
+		_idle.push_back(move(session));
+	}
+
+public:
+	// Checked-out session, handed back to the pool when the lease goes away
+	class Lease {
+	private:
+		SessionPool* _pool;
+		unique_ptr<GameSession> _session;
+
+	public:
+		Lease() : _pool(nullptr) {
+		}
+
+		Lease(SessionPool* pool, unique_ptr<GameSession> session) : _pool(pool), _session(move(session)) {
+		}
+
+		Lease(Lease&& other) = default;
+
+		Lease& operator=(Lease&& other) {
+			if (this != &other) {
+				if (_session) _pool->release(move(_session));
+				_pool = other._pool;
+				_session = move(other._session);
+			}
+			return *this;
+		}
+
+		~Lease() {
+			if (_session) _pool->release(move(_session));
+		}
+
+		explicit operator bool() const { return _session != nullptr; }
+		GameSession& operator*() const { return *_session; }
+		GameSession* operator->() const { return _session.get(); }
+	};
+
+	SessionPool(int boardSize = STANDARD_BOARD_SIZE, chrono::microseconds budget = ComputerPlayer::thinkBudget(Difficulty::Normal))
+		: _boardSize(boardSize), _budget(budget), _created(0) {
+		FleetSampler::requireFit(boardSize, StandardFleet::lengths());
+	}
+
+	SessionPool(const SessionPool&) = delete;
+	SessionPool& operator=(const SessionPool&) = delete;
+
+	// Kinds only this pool knows; add them before the first acquire()
+	void addFactory(const string& kind, StrategyFactory factory) {
+		_factories[kind] = factory;
+	}
+
+	// Builds count idle sessions up front
+	void reserve(size_t count, const string& first, const string& second) {
+		for (size_t i = 0; i < count; ++i) {
+			release(create(first, second));
+		}
+	}
+
+	// An idle session with these players, or a new one. Call reset() on it before playing.
+	Lease acquire(const string& first, const string& second) {
+		{
+			lock_guard<mutex> lock(_mutex);
+			for (size_t i = _idle.size(); i-- > 0;) {
+				if (_idle[i]->matches(first, second)) {
+					unique_ptr<GameSession> session = move(_idle[i]);
+					_idle[i] = move(_idle.back());
+					_idle.pop_back();
+					return Lease(this, move(session));
+				}
+			}
+		}
+		return Lease(this, create(first, second));
+	}
+
+	int getBoardSize() const { return _boardSize; }
+
+	size_t getCreated() {
+		lock_guard<mutex> lock(_mutex);
+		return _created;
+	}
+
+	size_t getIdle() {
+		lock_guard<mutex> lock(_mutex);
+		return _idle.size();
+	}
+};
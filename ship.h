@@ -6,36 +6,46 @@ private:
 	Point _start;
 	bool _horizontal;
 	int _length;
-	vector<Point> _hitPoints;
+	uint64_t _hitMask;   // Bit i - gəminin i-ci hüceyrəsi vurulub
+	int _remaining;      // Vurulmamış hüceyrələrin sayı
 
 public:
 	Ship(Point start, bool horizontal, int length)
-		: _start(start), _horizontal(horizontal), _length(length) {
+		: _start(start), _horizontal(horizontal), _length(length),
+		_hitMask(0), _remaining(length) {
+	}
+
+	Point getStart() const { return _start; }
+	bool isHorizontal() const { return _horizontal; }
+	int getLength() const { return _length; }
+	int getRemaining() const { return _remaining; }
+
+	// Position of p along the ship, or -1 if the ship does not cover p
+	int cellOffset(const Point& p) const {
+		int along = _horizontal ? p.getX() - _start.getX() : p.getY() - _start.getY();
+		int across = _horizontal ? p.getY() - _start.getY() : p.getX() - _start.getX();
+		if (across != 0 || along < 0 || along >= _length) return -1;
+		return along;
 	}
 
 	bool isHit(const Point& p) const {
-		vector<Point> occupied = getOccupiedPoints();
-		for (const auto& pos : occupied) {
-			if (pos == p) {
-				return true;
-			}
-		}
-		return false;
+		return cellOffset(p) >= 0;
 	}
 
-	void registerHit(const Point& p) {
-		if (isHit(p)) {
-			for (const auto& hit : _hitPoints) {
-				if (hit == p) {
-					return;
-				}
-			}
-			_hitPoints.push_back(p);
-		}
+	// Returns true if this was a new hit on the ship
+	bool registerHit(const Point& p) {
+		int offset = cellOffset(p);
+		if (offset < 0) return false;
+
+		uint64_t bit = 1ULL << offset;
+		if (_hitMask & bit) return false;
+		_hitMask |= bit;
+		--_remaining;
+		return true;
 	}
 
 	bool isSunk() const {
-		return _hitPoints.size() == _length;
+		return _remaining == 0;
 	}
 
 	// Gəminin tutduğu coordinatları qaytarır
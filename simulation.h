@@ -0,0 +1,230 @@
+#pragma once
+
+
+struct SimulationReport {
+	long long games = 0;
+	long long draws = 0;
+	long long firstPlayerWins = 0;
+	double seconds = 0.0;
+	int threads = 0;
+	uint64_t seed = 0;
+	vector<long long> shotsToWin; // shotsToWin[n] - n atəşlə qazanılan oyunlar
+
+	double gamesPerSecond() const {
+		return seconds > 0.0 ? games / seconds : 0.0;
+	}
+
+	double firstPlayerWinRate() const {
+		long long decided = games - draws;
+		return decided > 0 ? static_cast<double>(firstPlayerWins) / decided : 0.0;
+	}
+
+	double averageShotsToWin() const {
+		long long total = 0, count = 0;
+		for (size_t n = 0; n < shotsToWin.size(); ++n) {
+			total += shotsToWin[n] * static_cast<long long>(n);
+			count += shotsToWin[n];
+		}
+		return count > 0 ? static_cast<double>(total) / count : 0.0;
+	}
+
+	void merge(const SimulationReport& other) {
+		games += other.games;
+		draws += other.draws;
+		firstPlayerWins += other.firstPlayerWins;
+		if (shotsToWin.size() < other.shotsToWin.size()) {
+			shotsToWin.resize(other.shotsToWin.size(), 0);
+		}
+		for (size_t n = 0; n < other.shotsToWin.size(); ++n) {
+			shotsToWin[n] += other.shotsToWin[n];
+		}
+	}
+
+	void writeCsv(ostream& out) const {
+		out << "games,threads,seed,seconds,games_per_sec,first_player_win_rate,draws,avg_shots_to_win\n";
+		out << games << "," << threads << "," << seed << "," << seconds << "," << gamesPerSecond() << ","
+			<< firstPlayerWinRate() << "," << draws << "," << averageShotsToWin() << "\n";
+		out << "\nshots_to_win,games\n";
+		for (size_t n = 0; n < shotsToWin.size(); ++n) {
+			if (shotsToWin[n] > 0) out << n << "," << shotsToWin[n] << "\n";
+		}
+	}
+
+	void writeJson(ostream& out) const {
+		out << "{\n";
+		out << "  \"games\": " << games << ",\n";
+		out << "  \"threads\": " << threads << ",\n";
+		out << "  \"seed\": " << seed << ",\n";
+		out << "  \"seconds\": " << seconds << ",\n";
+		out << "  \"games_per_sec\": " << gamesPerSecond() << ",\n";
+		out << "  \"first_player_win_rate\": " << firstPlayerWinRate() << ",\n";
+		out << "  \"draws\": " << draws << ",\n";
+		out << "  \"avg_shots_to_win\": " << averageShotsToWin() << ",\n";
+		out << "  \"shots_to_win\": {";
+		bool first = true;
+		for (size_t n = 0; n < shotsToWin.size(); ++n) {
+			if (shotsToWin[n] == 0) continue;
+			out << (first ? "" : ", ") << "\"" << n << "\": " << shotsToWin[n];
+			first = false;
+		}
+		out << "}\n";
+		out << "}\n";
+	}
+};
+
+// Headless Computer vs Computer batch runner. No console output, no sleeps:
+// every worker thread owns two players and replays games back to back.
+class Simulation {
+private:
+	int _boardSize;
+	int _threads;
+	AIStrategy _strategy;
+	chrono::microseconds _thinkBudget;
+	uint64_t _seed;
+	GameArchiveWriter* _archive; // nullptr - oyunlar yazılmır
+	int _keyframeInterval;
+	bool _salvo;
+
+	static const int CHUNK = 64; // Bir dəfəyə götürülən oyun sayı
+	static const size_t ARCHIVE_FLUSH_BYTES = 1 << 20;
+
+	void runWorker(atomic<long long>& next, long long games, SimulationReport& report) {
+		Board board1(_boardSize);
+		Board board2(_boardSize);
+		ComputerPlayer player1(board1, _strategy);
+		ComputerPlayer player2(board2, _strategy);
+		for (ComputerPlayer* player : { &player1, &player2 }) {
+			player->setThinkBudget(_thinkBudget);
+			player->setSearchThreads(1);
+		}
+
+		report.shotsToWin.assign(_boardSize * _boardSize + 1, 0);
+
+		// Records are buffered per worker and appended to the archive in large blocks
+		GameRecord record;
+		BinaryWriter buffer, scratch;
+		GameRecord* recording = _archive ? &record : nullptr;
+
+		while (true) {
+			long long begin = next.fetch_add(CHUNK);
+			if (begin >= games) break;
+			long long end = min(begin + CHUNK, games);
+
+			for (long long g = begin; g < end; ++g) {
+				// Oyunun nəticəsi yalnız öz toxumundan asılıdır, axın sayından yox
+				seedGame(player1, player2, gameSeed(g));
+				player1.reset();
+				player2.reset();
+				player1.placeShips(true);
+				player2.placeShips(true);
+
+				if (recording) {
+					record.start(static_cast<uint64_t>(g), gameSeed(g),
+						player1.getBoard(), player2.getBoard(), _keyframeInterval);
+				}
+
+				GameResult result = _salvo ? playSalvoGame(player1, player2, _boardSize)
+					: playGame(player1, player2, _boardSize, recording);
+				if (recording) {
+					record.finish(result.winner);
+					GameArchiveWriter::encode(record, buffer, scratch);
+					if (buffer.size() >= ARCHIVE_FLUSH_BYTES) {
+						_archive->append(buffer);
+						buffer.clear();
+					}
+				}
+
+				report.games++;
+				if (result.winner < 0) {
+					report.draws++;
+					continue;
+				}
+				if (result.winner == 0) report.firstPlayerWins++;
+				if (result.shots < static_cast<int>(report.shotsToWin.size())) {
+					report.shotsToWin[result.shots]++;
+				}
+			}
+		}
+
+		if (buffer.size() > 0) _archive->append(buffer);
+	}
+
+public:
+	Simulation(int boardSize = STANDARD_BOARD_SIZE, int threads = 0, AIStrategy strategy = AIStrategy::Hunt,
+		chrono::microseconds thinkBudget = ComputerPlayer::thinkBudget(Difficulty::Easy),
+		uint64_t seed = 0)
+		: _boardSize(boardSize),
+		_threads(threads > 0 ? threads : max(1u, thread::hardware_concurrency())),
+		_strategy(strategy), _thinkBudget(thinkBudget), _seed(seed),
+		_archive(nullptr), _keyframeInterval(GameRecord::DEFAULT_KEYFRAME_INTERVAL), _salvo(false) {
+		FleetSampler::requireFit(boardSize, StandardFleet::lengths());
+	}
+
+	// Every game played by run() is appended to the archive
+	void setArchive(GameArchiveWriter* archive, int keyframeInterval = GameRecord::DEFAULT_KEYFRAME_INTERVAL) {
+		_archive = archive;
+		_keyframeInterval = keyframeInterval;
+	}
+
+	// Salvo rules for every game (see GameDriver::playSalvo); no archive with these
+	void setSalvo(bool salvo) {
+		_salvo = salvo;
+	}
+
+	uint64_t gameSeed(long long game) const {
+		return Rng::derive(_seed, static_cast<uint64_t>(game));
+	}
+
+	static void seedGame(Player& first, Player& second, uint64_t gameSeed) {
+		first.reseed(Rng::derive(gameSeed, 1));
+		second.reseed(Rng::derive(gameSeed, 2));
+	}
+
+	// Plays one game through GameDriver, statically dispatched for concrete player types
+	template <class First, class Second>
+	static GameResult playGame(First& first, Second& second, int boardSize, GameRecord* record = nullptr) {
+		return GameDriver<First, Second>::play(first, second, boardSize, record);
+	}
+
+	template <class First, class Second>
+	static GameResult playSalvoGame(First& first, Second& second, int boardSize) {
+		return GameDriver<First, Second>::playSalvo(first, second, boardSize);
+	}
+
+	SimulationReport run(long long games) {
+		if (_salvo && _archive) throw logic_error("Salvo games cannot be recorded");
+
+		vector<SimulationReport> partial(_threads);
+		vector<exception_ptr> failures(_threads);
+		vector<thread> workers;
+		atomic<long long> next(0);
+
+		auto started = chrono::steady_clock::now();
+		for (int t = 0; t < _threads; ++t) {
+			workers.emplace_back([this, &next, games, &partial, &failures, t] {
+				try {
+					runWorker(next, games, partial[t]);
+				}
+				catch (...) {
+					failures[t] = current_exception();
+					next.store(games); // Qalan oyunlar oynanmasın
+				}
+			});
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		for (const exception_ptr& failure : failures) {
+			if (failure) rethrow_exception(failure);
+		}
+
+		SimulationReport report;
+		report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+		report.threads = _threads;
+		report.seed = _seed;
+		for (const auto& part : partial) {
+			report.merge(part);
+		}
+		return report;
+	}
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+
+// Keyboard input for the console with a Windows (conio) and a POSIX
+// (termios + poll) backend. readKey() waits for a key or a timeout and
+// decodes arrow keys into the KEY_* codes from constants.h, and
+// waitForKey() replaces Sleep(): a pause ends as soon as a key arrives,
+// and the key is left in the buffer for the next readKey().
+class Terminal {
+private:
+	// Time left until deadline in milliseconds, -1 = no deadline
+	static int remainingMs(int timeoutMs, chrono::steady_clock::time_point deadline) {
+		if (timeoutMs < 0) return -1;
+		auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now());
+		return max(0, static_cast<int>(left.count()));
+	}
+
+#ifdef _WIN32
+	Terminal() {
+	}
+
+	static int decodeExtended(int code) {
+		switch (code) {
+		case 72: return KEY_UP;
+		case 80: return KEY_DOWN;
+		case 75: return KEY_LEFT;
+		case 77: return KEY_RIGHT;
+		default: return KEY_NONE;
+		}
+	}
+#else
+	static const int ESCAPE_TIMEOUT_MS = 30;
+
+	bool _raw;
+
+	static termios& savedMode() {
+		static termios mode;
+		return mode;
+	}
+
+	// Ctrl+C must not leave the shell without echo
+	static void restoreOnSignal(int sig) {
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedMode());
+		signal(sig, SIG_DFL);
+		raise(sig);
+	}
+
+	// Non-canonical, no echo; signals and output processing stay as they are
+	Terminal() : _raw(false) {
+		if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedMode()) != 0) return;
+
+		termios raw = savedMode();
+		raw.c_lflag &= ~(ICANON | ECHO);
+		raw.c_cc[VMIN] = 1;
+		raw.c_cc[VTIME] = 0;
+		if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == 0) {
+			_raw = true;
+			signal(SIGINT, restoreOnSignal);
+			signal(SIGTERM, restoreOnSignal);
+		}
+	}
+
+	bool readByte(unsigned char& byte, int timeoutMs) {
+		return waitForKey(timeoutMs) && read(STDIN_FILENO, &byte, 1) == 1;
+	}
+
+	// Arrow keys arrive as ESC [ A or ESC O A, modified ones as ESC [ 1 ; 5 A.
+	// A lone ESC (nothing follows quickly) is the Escape key itself.
+	int decodeEscape() {
+		unsigned char byte;
+		if (!readByte(byte, ESCAPE_TIMEOUT_MS)) return ESC;
+		if (byte != '[' && byte != 'O') return KEY_NONE;
+
+		// Parametr baytlarını keç, son bayt açarı göstərir
+		do {
+			if (!readByte(byte, ESCAPE_TIMEOUT_MS)) return KEY_NONE;
+		} while (byte >= '0' && byte <= '?');
+
+		switch (byte) {
+		case 'A': return KEY_UP;
+		case 'B': return KEY_DOWN;
+		case 'C': return KEY_RIGHT;
+		case 'D': return KEY_LEFT;
+		default: return KEY_NONE;
+		}
+	}
+#endif
+
+public:
+	static const int KEY_NONE = -1;
+
+	Terminal(const Terminal&) = delete;
+	Terminal& operator=(const Terminal&) = delete;
+
+	~Terminal() {
+#ifndef _WIN32
+		if (_raw) tcsetattr(STDIN_FILENO, TCSAFLUSH, &savedMode());
+#endif
+	}
+
+	static Terminal& shared() {
+		static Terminal terminal;
+		return terminal;
+	}
+
+	// True once a key is waiting; false if timeoutMs passed first (-1 = wait forever)
+	bool waitForKey(int timeoutMs) {
+		auto deadline = chrono::steady_clock::now() + chrono::milliseconds(max(timeoutMs, 0));
+#ifdef _WIN32
+		HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+		while (!_kbhit()) {
+			int left = remainingMs(timeoutMs, deadline);
+			if (left == 0) return false;
+			if (WaitForSingleObject(input, left < 0 ? INFINITE : static_cast<DWORD>(left)) != WAIT_OBJECT_0) {
+				return false;
+			}
+			// Woken by a mouse, focus or key-up record - drop it
+			if (!_kbhit()) {
+				INPUT_RECORD record;
+				DWORD count = 0;
+				ReadConsoleInputA(input, &record, 1, &count);
+			}
+		}
+		return true;
+#else
+		pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+		while (true) {
+			int ready = poll(&fd, 1, remainingMs(timeoutMs, deadline));
+			if (ready > 0) return true;
+			if (ready == 0 || errno != EINTR) return false;
+		}
+#endif
+	}
+
+	// Next key: a character, ENTER_KEY, ESC or KEY_UP/DOWN/LEFT/RIGHT.
+	// KEY_NONE on timeout or for keys the game does not use, KEY_EOF once
+	// stdin is closed - every later call returns it again at once.
+	int readKey(int timeoutMs = -1) {
+		if (!waitForKey(timeoutMs)) return KEY_NONE;
+		Metrics::inputRead();
+#ifdef _WIN32
+		int c = _getch();
+		if (c == 0 || c == 224) return decodeExtended(_getch());
+		return c;
+#else
+		unsigned char byte;
+		if (read(STDIN_FILENO, &byte, 1) != 1) return KEY_EOF;
+		if (byte == 27) return decodeEscape();
+		if (byte == '\n' || byte == '\r') return ENTER_KEY;
+		return byte;
+#endif
+	}
+
+	// Drops keys typed ahead, e.g. while an animation was skipped
+	void flushInput() {
+		while (waitForKey(0)) {
+			if (readKey(0) == KEY_EOF) return;
+		}
+	}
+};
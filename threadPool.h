@@ -0,0 +1,70 @@
+#pragma once
+
+
+// Fixed-size pool of worker threads fed from a single task queue.
+class ThreadPool {
+private:
+	vector<thread> _workers;
+	queue<function<void()>> _tasks;
+	mutex _mutex;
+	condition_variable _ready;
+	bool _stopping;
+
+	void workerLoop() {
+		while (true) {
+			function<void()> task;
+			{
+				unique_lock<mutex> lock(_mutex);
+				_ready.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+				if (_stopping && _tasks.empty()) return;
+				task = move(_tasks.front());
+				_tasks.pop();
+			}
+			task();
+		}
+	}
+
+public:
+	explicit ThreadPool(int threads = 0) : _stopping(false) {
+		if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+		for (int i = 0; i < threads; ++i) {
+			_workers.emplace_back(&ThreadPool::workerLoop, this);
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	~ThreadPool() {
+		{
+			lock_guard<mutex> lock(_mutex);
+			_stopping = true;
+		}
+		_ready.notify_all();
+		for (auto& worker : _workers) {
+			worker.join();
+		}
+	}
+
+	int size() const {
+		return static_cast<int>(_workers.size());
+	}
+
+	template <class Task>
+	future<void> submit(Task task) {
+		auto packaged = make_shared<packaged_task<void()>>(move(task));
+		future<void> result = packaged->get_future();
+		{
+			lock_guard<mutex> lock(_mutex);
+			_tasks.emplace([packaged] { (*packaged)(); });
+		}
+		_ready.notify_one();
+		return result;
+	}
+
+	// Process-wide pool sized to the machine, created on first use
+	static ThreadPool& shared() {
+		static ThreadPool pool;
+		return pool;
+	}
+};
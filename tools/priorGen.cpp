@@ -0,0 +1,231 @@
+#include <iostream>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+
+#include "../fleet.h"
+#include "../point.h"
+#include "../bitBoard.h"
+#include "../rng.h"
+#include "../placementTable.h"
+
+
+// Offline generator for priorTable.h: the chance that each cell of the
+// standard board holds a ship, and an opening sequence built on it.
+//
+// Exact counting is out of reach (the standard fleet has trillions of
+// layouts), so layouts are drawn the way MonteCarloSearch draws them - each
+// ship uniformly among the placements left - and weighted by how many
+// choices each step had. Weighted that way, every layout counts equally,
+// which a plain draw does not give. The board's eight symmetries are
+// averaged in to cut the noise further.
+//
+// priorGen [--samples N] [--seed S] [--opening K] [--out file]
+
+const int BOARD_SIZE = STANDARD_BOARD_SIZE;
+const int CELL_COUNT = BOARD_SIZE * BOARD_SIZE;
+
+struct Sample {
+	uint64_t ships[2];
+	double weight;
+};
+
+// Cell after one of the eight rotations and reflections of the square
+int transform(int cell, int symmetry) {
+	int x = cell % BOARD_SIZE, y = cell / BOARD_SIZE;
+	if (symmetry & 1) x = BOARD_SIZE - 1 - x;
+	if (symmetry & 2) y = BOARD_SIZE - 1 - y;
+	if (symmetry & 4) swap(x, y);
+	return y * BOARD_SIZE + x;
+}
+
+// Undoes transform(): the flips commute, the swap has to come off first
+int untransform(int cell, int symmetry) {
+	int x = cell % BOARD_SIZE, y = cell / BOARD_SIZE;
+	if (symmetry & 4) swap(x, y);
+	if (symmetry & 2) y = BOARD_SIZE - 1 - y;
+	if (symmetry & 1) x = BOARD_SIZE - 1 - x;
+	return y * BOARD_SIZE + x;
+}
+
+bool hasShip(const Sample& s, int cell) {
+	return (s.ships[cell >> 6] >> (cell & 63)) & 1;
+}
+
+vector<Sample> drawSamples(long long count, uint64_t seed) {
+	vector<int> lengths = StandardFleet::lengths();
+	shared_ptr<const PlacementTable> table = PlacementTable::get(BOARD_SIZE, StandardFleet::longest());
+	Rng rng(seed);
+	BitBoard blocked(CELL_COUNT);
+	vector<int> candidates;
+	vector<double> logWeights;
+	vector<Sample> samples;
+	samples.reserve(count);
+
+	while (static_cast<long long>(samples.size()) < count) {
+		blocked.clear();
+		Sample s = { { 0, 0 }, 0 };
+		double logWeight = 0;
+		bool complete = true;
+
+		for (int length : lengths) {
+			candidates.clear();
+			for (int p : table->withLength(length)) {
+				if (table->isFree(p, blocked)) candidates.push_back(p);
+			}
+			if (candidates.empty()) {
+				complete = false; // Çəkisi sıfırdır - sadəcə atılır
+				break;
+			}
+
+			int p = candidates[rng.nextInt(static_cast<int>(candidates.size()))];
+			logWeight += log(static_cast<double>(candidates.size()));
+			table->occupy(p, blocked);
+			const uint64_t* mask = table->cellMask(p);
+			s.ships[0] |= mask[0];
+			s.ships[1] |= mask[1];
+		}
+		if (!complete) continue;
+
+		samples.push_back(s);
+		logWeights.push_back(logWeight);
+	}
+
+	// Weights relative to the largest, so exp() stays in range
+	double top = *max_element(logWeights.begin(), logWeights.end());
+	double sum = 0, squares = 0;
+	for (size_t i = 0; i < samples.size(); ++i) {
+		samples[i].weight = exp(logWeights[i] - top);
+		sum += samples[i].weight;
+		squares += samples[i].weight * samples[i].weight;
+	}
+	cerr << "effective sample size " << static_cast<long long>(sum * sum / squares) << " of " << samples.size() << endl;
+	return samples;
+}
+
+// Weighted ship chance per cell over the samples with no ship on any missed cell
+vector<double> occupancy(const vector<Sample>& samples, const vector<int>& missed) {
+	vector<double> sum(CELL_COUNT, 0);
+	double total = 0;
+	for (int symmetry = 0; symmetry < 8; ++symmetry) {
+		vector<int> misses;
+		for (int cell : missed) misses.push_back(transform(cell, symmetry));
+
+		for (const Sample& s : samples) {
+			bool consistent = true;
+			for (int cell : misses) {
+				if (hasShip(s, cell)) {
+					consistent = false;
+					break;
+				}
+			}
+			if (!consistent) continue;
+
+			total += s.weight;
+			for (int w = 0; w < 2; ++w) {
+				for (uint64_t bits = s.ships[w]; bits != 0; bits &= bits - 1) {
+					int cell = w * 64 + countTrailingZeros(bits);
+					sum[untransform(cell, symmetry)] += s.weight;
+				}
+			}
+		}
+	}
+
+	for (double& value : sum) value = total > 0 ? value / total : 0;
+	return sum;
+}
+
+// Each shot is the likeliest ship cell given that every shot before it missed
+vector<int> openingSequence(const vector<Sample>& samples, int length) {
+	vector<int> opening;
+	for (int k = 0; k < length; ++k) {
+		vector<double> chance = occupancy(samples, opening);
+		int best = -1;
+		for (int cell = 0; cell < CELL_COUNT; ++cell) {
+			if (find(opening.begin(), opening.end(), cell) != opening.end()) continue;
+			if (best < 0 || chance[cell] > chance[best] + 1e-12) best = cell;
+		}
+		opening.push_back(best);
+		cerr << "opening " << k + 1 << "/" << length << ": cell " << best << " (" << chance[best] << ")" << endl;
+	}
+	return opening;
+}
+
+void writeTable(ostream& out, long long samples, const vector<double>& prior, const vector<int>& opening) {
+	out << "#pragma once\n\n"
+		<< "// Generated by tools/priorGen.cpp (make prior) - do not edit by hand.\n"
+		<< "// Standard fleet on the standard board, " << samples << " weighted layouts.\n\n"
+		<< "const int PRIOR_BOARD_SIZE = " << BOARD_SIZE << ";\n\n"
+		<< "// Chance that each cell holds a ship before any shot, row-major\n"
+		<< "constexpr float PRIOR_OCCUPANCY[" << CELL_COUNT << "] = {\n";
+	out << fixed << setprecision(5);
+	for (int y = 0; y < BOARD_SIZE; ++y) {
+		out << "\t";
+		for (int x = 0; x < BOARD_SIZE; ++x) {
+			out << prior[y * BOARD_SIZE + x] << "f" << (y * BOARD_SIZE + x + 1 < CELL_COUNT ? "," : "") << (x + 1 < BOARD_SIZE ? " " : "");
+		}
+		out << "\n";
+	}
+	out << "};\n\n"
+		<< "// Shots to open with while nothing is hit: each is the likeliest ship\n"
+		<< "// cell given that all shots before it missed\n"
+		<< "const int PRIOR_OPENING_LENGTH = " << opening.size() << ";\n"
+		<< "constexpr unsigned char PRIOR_OPENING[PRIOR_OPENING_LENGTH] = {\n\t";
+	for (size_t i = 0; i < opening.size(); ++i) {
+		out << opening[i] << (i + 1 < opening.size() ? ", " : "\n");
+	}
+	out << "};\n";
+}
+
+
+int main(int argc, char* argv[]) {
+	long long samples = 2000000;
+	uint64_t seed = 20240601;
+	int openingLength = 16;
+	string outPath = "priorTable.h";
+
+	for (int i = 1; i < argc; ++i) {
+		string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--samples" && hasValue) samples = atoll(argv[++i]);
+		else if (arg == "--seed" && hasValue) seed = strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--opening" && hasValue) openingLength = atoi(argv[++i]);
+		else if (arg == "--out" && hasValue) outPath = argv[++i];
+		else {
+			cerr << "Usage: " << argv[0] << " [--samples N] [--seed S] [--opening K] [--out file]" << endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if (samples <= 0 || openingLength <= 0 || openingLength > CELL_COUNT) {
+		cerr << "Error: --samples and --opening must be positive" << endl;
+		return EXIT_FAILURE;
+	}
+
+	vector<Sample> drawn = drawSamples(samples, seed);
+	vector<double> prior = occupancy(drawn, vector<int>());
+	vector<int> opening = openingSequence(drawn, openingLength);
+
+	ofstream out(outPath);
+	if (!out) {
+		cerr << "Error: Cannot write " << outPath << endl;
+		return EXIT_FAILURE;
+	}
+	writeTable(out, samples, prior, opening);
+	return EXIT_SUCCESS;
+}
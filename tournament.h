@@ -0,0 +1,388 @@
+#pragma once
+
+
+// Creates a player for a tournament seat. budget is the per-move think
+// time for strategies that search (ignored by the others).
+typedef function<unique_ptr<Player>(Board&, chrono::microseconds budget)> StrategyFactory;
+
+// Named strategies the tournament can enter. New AIs register here once
+// and can then be pitted against every other entry.
+class StrategyRegistry {
+private:
+	static vector<pair<string, StrategyFactory>>& entries() {
+		static vector<pair<string, StrategyFactory>> list = builtins();
+		return list;
+	}
+
+	static unique_ptr<Player> computer(Board& board, AIStrategy strategy, chrono::microseconds budget) {
+		auto player = make_unique<ComputerPlayer>(board, strategy, Rng(0));
+		player->setThinkBudget(budget);
+		player->setSearchThreads(1); // Paralellik oyunlar arasındadır
+		return move(player);
+	}
+
+	static vector<pair<string, StrategyFactory>> builtins() {
+		vector<pair<string, StrategyFactory>> list;
+		list.push_back(make_pair(string("random"), [](Board& board, chrono::microseconds) {
+			return unique_ptr<Player>(new RandomPlayer(board, Rng(0)));
+		}));
+		list.push_back(make_pair(string("hunt"), [](Board& board, chrono::microseconds budget) {
+			return computer(board, AIStrategy::Hunt, budget);
+		}));
+		list.push_back(make_pair(string("density"), [](Board& board, chrono::microseconds budget) {
+			return computer(board, AIStrategy::Density, budget);
+		}));
+		list.push_back(make_pair(string("endgame"), [](Board& board, chrono::microseconds budget) {
+			auto player = computer(board, AIStrategy::Density, budget);
+			static_cast<ComputerPlayer&>(*player).setEndgameSolver(true);
+			return player;
+		}));
+		list.push_back(make_pair(string("montecarlo"), [](Board& board, chrono::microseconds budget) {
+			return computer(board, AIStrategy::MonteCarlo, budget);
+		}));
+		return list;
+	}
+
+public:
+	// Replaces an entry with the same name
+	static void add(const string& name, StrategyFactory factory) {
+		for (auto& entry : entries()) {
+			if (entry.first == name) {
+				entry.second = factory;
+				return;
+			}
+		}
+		entries().push_back(make_pair(name, factory));
+	}
+
+	static const StrategyFactory& get(const string& name) {
+		for (const auto& entry : entries()) {
+			if (entry.first == name) return entry.second;
+		}
+		throw invalid_argument("Unknown strategy: " + name);
+	}
+
+	static vector<string> names() {
+		vector<string> result;
+		for (const auto& entry : entries()) result.push_back(entry.first);
+		return result;
+	}
+};
+
+
+// Result of one pairing, from the point of view of the first entry
+struct PairingResult {
+	int first;
+	int second;
+	long long wins = 0;
+	long long losses = 0;
+	long long draws = 0;
+	bool stoppedEarly = false;
+
+	long long games() const { return wins + losses + draws; }
+
+	double score() const {
+		return games() > 0 ? (wins + 0.5 * draws) / games() : 0.5;
+	}
+
+	// Half-width of the confidence interval on score() for normal quantile z
+	double margin(double z) const {
+		long long n = games();
+		if (n < 2) return 0.5;
+		double p = score();
+		double variance = (wins * (1 - p) * (1 - p) + draws * (0.5 - p) * (0.5 - p) + losses * p * p) / n;
+		return z * sqrt(variance / n);
+	}
+
+	static double eloFromScore(double score) {
+		score = min(max(score, 0.001), 0.999);
+		return -400.0 * log10(1.0 / score - 1.0);
+	}
+};
+
+struct TournamentReport {
+	vector<string> names;
+	vector<PairingResult> pairings;
+	vector<double> elo;          // Orta reytinq 0-dır
+	vector<double> eloMargin;    // 95% etibarlılıq intervalının yarısı
+	long long games = 0;
+	long long steals = 0;
+	double seconds = 0.0;
+	int threads = 0;
+	uint64_t seed = 0;
+
+	// Score of entry a against entry b, or -1 if they did not meet
+	double scoreOf(int a, int b) const {
+		for (const auto& p : pairings) {
+			if (p.first == a && p.second == b) return p.score();
+			if (p.first == b && p.second == a) return 1.0 - p.score();
+		}
+		return -1.0;
+	}
+
+	// Bradley-Terry strengths by minorization-maximization, draws as half a
+	// win. One virtual draw per pairing keeps unbeaten entries finite.
+	void computeRatings() {
+		int n = static_cast<int>(names.size());
+		vector<double> gamma(n, 1.0), won(n, 0.0);
+		for (const auto& p : pairings) {
+			won[p.first] += p.wins + 0.5 * p.draws + 0.5;
+			won[p.second] += p.losses + 0.5 * p.draws + 0.5;
+		}
+
+		for (int iteration = 0; iteration < 1000; ++iteration) {
+			vector<double> denominator(n, 0.0);
+			for (const auto& p : pairings) {
+				double games = p.games() + 1.0;
+				double sum = gamma[p.first] + gamma[p.second];
+				denominator[p.first] += games / sum;
+				denominator[p.second] += games / sum;
+			}
+			double logMean = 0.0, change = 0.0;
+			for (int i = 0; i < n; ++i) {
+				double next = denominator[i] > 0 ? won[i] / denominator[i] : gamma[i];
+				change = max(change, fabs(log(next / gamma[i])));
+				gamma[i] = next;
+				logMean += log(gamma[i]) / n;
+			}
+			for (int i = 0; i < n; ++i) gamma[i] /= exp(logMean);
+			if (change < 1e-9) break;
+		}
+
+		// Standard error from the Fisher information of each rating
+		const double eloPerLog = 400.0 / log(10.0);
+		elo.assign(n, 0.0);
+		eloMargin.assign(n, 0.0);
+		vector<double> information(n, 0.0);
+		for (const auto& p : pairings) {
+			double a = gamma[p.first], b = gamma[p.second];
+			double share = a * b / ((a + b) * (a + b));
+			information[p.first] += (p.games() + 1.0) * share;
+			information[p.second] += (p.games() + 1.0) * share;
+		}
+		for (int i = 0; i < n; ++i) {
+			elo[i] = eloPerLog * log(gamma[i]);
+			eloMargin[i] = information[i] > 0 ? 1.96 * eloPerLog / sqrt(information[i]) : 0.0;
+		}
+	}
+
+	void writeText(ostream& out) const {
+		int n = static_cast<int>(names.size());
+		out << games << " games in " << fixed << setprecision(2) << seconds << " s on " << threads
+			<< " threads (" << steals << " steals), seed " << seed << "\n\n";
+
+		out << "Ratings (Elo, 95% CI)\n";
+		vector<int> order(n);
+		for (int i = 0; i < n; ++i) order[i] = i;
+		sort(order.begin(), order.end(), [this](int a, int b) { return elo[a] > elo[b]; });
+		for (int i : order) {
+			out << "  " << left << setw(14) << names[i] << right << setw(8) << setprecision(0) << elo[i]
+				<< " +/- " << eloMargin[i] << "\n";
+		}
+
+		out << "\nWin matrix (row's score vs column, %)\n" << setw(14) << "";
+		for (int j = 0; j < n; ++j) out << setw(12) << names[j];
+		out << "\n";
+		for (int i = 0; i < n; ++i) {
+			out << left << setw(14) << names[i] << right;
+			for (int j = 0; j < n; ++j) {
+				double s = scoreOf(i, j);
+				if (s < 0) out << setw(12) << "-";
+				else out << setw(12) << setprecision(1) << 100.0 * s;
+			}
+			out << "\n";
+		}
+
+		out << "\nPairings\n";
+		for (const auto& p : pairings) {
+			double low = PairingResult::eloFromScore(p.score() - p.margin(1.96));
+			double high = PairingResult::eloFromScore(p.score() + p.margin(1.96));
+			out << "  " << names[p.first] << " vs " << names[p.second] << ": +" << p.wins << " -" << p.losses
+				<< " =" << p.draws << " (" << p.games() << " games" << (p.stoppedEarly ? ", settled early" : "")
+				<< "), Elo diff " << setprecision(0) << PairingResult::eloFromScore(p.score())
+				<< " [" << low << ", " << high << "]\n";
+		}
+		out.unsetf(ios::floatfield);
+	}
+
+	void writeJson(ostream& out) const {
+		out << "{\n";
+		out << "  \"games\": " << games << ",\n";
+		out << "  \"threads\": " << threads << ",\n";
+		out << "  \"seed\": " << seed << ",\n";
+		out << "  \"seconds\": " << seconds << ",\n";
+		out << "  \"steals\": " << steals << ",\n";
+		out << "  \"ratings\": [";
+		for (size_t i = 0; i < names.size(); ++i) {
+			out << (i ? ", " : "") << "{\"name\": \"" << names[i] << "\", \"elo\": " << elo[i]
+				<< ", \"ci95\": " << eloMargin[i] << "}";
+		}
+		out << "],\n";
+		out << "  \"pairings\": [";
+		for (size_t i = 0; i < pairings.size(); ++i) {
+			const auto& p = pairings[i];
+			out << (i ? ", " : "") << "{\"first\": \"" << names[p.first] << "\", \"second\": \"" << names[p.second]
+				<< "\", \"wins\": " << p.wins << ", \"losses\": " << p.losses << ", \"draws\": " << p.draws
+				<< ", \"score\": " << p.score() << ", \"score_ci95\": " << p.margin(1.96)
+				<< ", \"stopped_early\": " << (p.stoppedEarly ? "true" : "false") << "}";
+		}
+		out << "]\n";
+		out << "}\n";
+	}
+};
+
+
+// Round-robin between registered strategies. Every pairing is split into
+// batches of games that a WorkStealingRunner spreads over the cores.
+// After each batch the pairing is checked: once the confidence interval
+// on its score clears 50% (or is narrower than the wanted precision) the
+// remaining batches are skipped. Seats alternate between games, and every
+// game has its own seed derived from the tournament seed.
+class Tournament {
+private:
+	struct Batch {
+		int pairing;
+		long long begin;
+		long long end;
+	};
+
+	struct PairingState {
+		mutex lock;
+		PairingResult result;
+		atomic<bool> stopped;
+		PairingState() : stopped(false) {}
+	};
+
+	int _boardSize;
+	int _threads;
+	uint64_t _seed;
+	chrono::microseconds _thinkBudget;
+	vector<string> _entrants;
+	long long _batchSize;
+	long long _minGames;    // Erkən dayanma bu qədər oyundan sonra mümkündür
+	double _stopZ;          // 0 - erkən dayanma yoxdur
+	double _precision;
+
+	vector<unique_ptr<PairingState>> _pairings;
+	vector<vector<unique_ptr<Player>>> _players; // [axın][iştirakçı]
+
+	Player& player(int worker, int entrant) {
+		unique_ptr<Player>& slot = _players[worker][entrant];
+		if (!slot) {
+			Board board(_boardSize);
+			slot = StrategyRegistry::get(_entrants[entrant])(board, _thinkBudget);
+		}
+		return *slot;
+	}
+
+	void playBatch(int worker, const Batch& batch) {
+		PairingState& state = *_pairings[batch.pairing];
+		if (state.stopped.load(memory_order_relaxed)) return;
+
+		Player& a = player(worker, state.result.first);
+		Player& b = player(worker, state.result.second);
+		long long wins = 0, losses = 0, draws = 0;
+
+		for (long long g = batch.begin; g < batch.end; ++g) {
+			bool swapped = (g & 1) != 0;
+			Player& first = swapped ? b : a;
+			Player& second = swapped ? a : b;
+
+			uint64_t gameSeed = Rng::derive(Rng::derive(_seed, static_cast<uint64_t>(batch.pairing)), static_cast<uint64_t>(g));
+			Simulation::seedGame(first, second, gameSeed);
+			first.reset();
+			second.reset();
+			first.placeShips(true);
+			second.placeShips(true);
+
+			GameResult result = Simulation::playGame(first, second, _boardSize);
+			if (result.winner < 0) draws++;
+			else if ((result.winner == 0) != swapped) wins++;
+			else losses++;
+		}
+
+		lock_guard<mutex> guard(state.lock);
+		PairingResult& r = state.result;
+		r.wins += wins;
+		r.losses += losses;
+		r.draws += draws;
+		if (_stopZ > 0 && r.games() >= _minGames && !r.stoppedEarly) {
+			double margin = r.margin(_stopZ);
+			if (fabs(r.score() - 0.5) > margin || margin < _precision) {
+				r.stoppedEarly = true;
+				state.stopped.store(true, memory_order_relaxed);
+			}
+		}
+	}
+
+public:
+	Tournament(int boardSize = STANDARD_BOARD_SIZE, int threads = 0, uint64_t seed = 0,
+		chrono::microseconds thinkBudget = ComputerPlayer::thinkBudget(Difficulty::Easy))
+		: _boardSize(boardSize),
+		_threads(threads > 0 ? threads : max(1, static_cast<int>(thread::hardware_concurrency()))),
+		_seed(seed), _thinkBudget(thinkBudget), _batchSize(32), _minGames(200),
+		_stopZ(3.0), _precision(0.02) {
+		FleetSampler::requireFit(boardSize, StandardFleet::lengths());
+	}
+
+	void addEntrant(const string& name) {
+		StrategyRegistry::get(name); // Adı yoxla
+		_entrants.push_back(name);
+	}
+
+	void setBatchSize(long long games) {
+		_batchSize = max(2LL, games & ~1LL); // Cüt - oturacaqlar bərabər bölünsün
+	}
+
+	// z = 0 turns early stopping off. A high z (3 by default) keeps the
+	// repeated checks from declaring a winner by chance.
+	void setEarlyStop(long long minGames, double z, double precision) {
+		_minGames = minGames;
+		_stopZ = z;
+		_precision = precision;
+	}
+
+	TournamentReport run(long long gamesPerPairing) {
+		int n = static_cast<int>(_entrants.size());
+		if (n < 2) throw invalid_argument("A tournament needs at least two entrants");
+
+		_pairings.clear();
+		for (int i = 0; i < n; ++i) {
+			for (int j = i + 1; j < n; ++j) {
+				_pairings.push_back(make_unique<PairingState>());
+				_pairings.back()->result.first = i;
+				_pairings.back()->result.second = j;
+			}
+		}
+
+		// Batch-major order: every pairing gets its first batches early, so
+		// settled pairings stop before most of their work is scheduled
+		vector<Batch> batches;
+		for (long long begin = 0; begin < gamesPerPairing; begin += _batchSize) {
+			for (int p = 0; p < static_cast<int>(_pairings.size()); ++p) {
+				batches.push_back(Batch{ p, begin, min(begin + _batchSize, gamesPerPairing) });
+			}
+		}
+
+		_players.clear();
+		_players.resize(_threads);
+		for (auto& row : _players) row.resize(n);
+
+		WorkStealingRunner<Batch> runner(_threads);
+		auto started = chrono::steady_clock::now();
+		runner.run(batches, [this](int worker, const Batch& batch) { playBatch(worker, batch); });
+
+		TournamentReport report;
+		report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+		report.names = _entrants;
+		report.threads = _threads;
+		report.seed = _seed;
+		report.steals = runner.getSteals();
+		for (const auto& state : _pairings) {
+			report.pairings.push_back(state->result);
+			report.games += state->result.games();
+		}
+		report.computeRatings();
+		return report;
+	}
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+
+// Runs a fixed list of jobs on a set of threads. The jobs are dealt out
+// round-robin into one queue per thread. Each thread works through its own
+// queue in order; when that runs dry it steals from another thread's queue
+// instead of idling, so a few slow jobs (long games, expensive strategies)
+// do not leave the other cores waiting.
+template <class Job>
+class WorkStealingRunner {
+private:
+	struct WorkerQueue {
+		mutex lock;
+		deque<Job> jobs;
+	};
+
+	int _threads;
+	vector<unique_ptr<WorkerQueue>> _queues;
+	atomic<long long> _steals;
+
+	bool take(int worker, Job& job) {
+		WorkerQueue& own = *_queues[worker];
+		lock_guard<mutex> guard(own.lock);
+		if (own.jobs.empty()) return false;
+		job = move(own.jobs.front());
+		own.jobs.pop_front();
+		return true;
+	}
+
+	// Victims are scanned from a random start so thieves do not pile onto one queue
+	bool steal(int thief, Rng& rng, Job& job) {
+		int start = rng.nextInt(_threads);
+		for (int i = 0; i < _threads; ++i) {
+			int victim = (start + i) % _threads;
+			if (victim == thief) continue;
+
+			WorkerQueue& queue = *_queues[victim];
+			lock_guard<mutex> guard(queue.lock);
+			if (queue.jobs.empty()) continue;
+			job = move(queue.jobs.back());
+			queue.jobs.pop_back();
+			_steals.fetch_add(1, memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	template <class Body>
+	void workerLoop(int worker, Body& body) {
+		Rng rng(Rng::derive(0x5EA1, static_cast<uint64_t>(worker)));
+		Job job;
+		// Növbələr yalnız boşalır - hamısı boşdursa iş bitib
+		while (take(worker, job) || steal(worker, rng, job)) {
+			body(worker, job);
+		}
+	}
+
+public:
+	explicit WorkStealingRunner(int threads = 0)
+		: _threads(threads > 0 ? threads : max(1, static_cast<int>(thread::hardware_concurrency()))),
+		_steals(0) {
+		for (int i = 0; i < _threads; ++i) {
+			_queues.push_back(make_unique<WorkerQueue>());
+		}
+	}
+
+	int getThreads() const { return _threads; }
+	long long getSteals() const { return _steals.load(); }
+
+	// body(worker, job) - worker is the thread index, e.g. for per-thread state
+	template <class Body>
+	void run(const vector<Job>& jobs, Body body) {
+		for (size_t i = 0; i < jobs.size(); ++i) {
+			_queues[i % _threads]->jobs.push_back(jobs[i]);
+		}
+
+		// A job that throws stops its thread; the first such error is rethrown here
+		vector<exception_ptr> failures(_threads);
+		vector<thread> workers;
+		for (int t = 0; t < _threads; ++t) {
+			workers.emplace_back([this, t, &body, &failures] {
+				try {
+					workerLoop(t, body);
+				}
+				catch (...) {
+					failures[t] = current_exception();
+				}
+			});
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		for (const exception_ptr& failure : failures) {
+			if (failure) rethrow_exception(failure);
+		}
+	}
+};